@@ -4,8 +4,14 @@
 #include <iostream>
 #include <assert.h>
 #include <limits>
+#include <ctime>
+#include <vector>
+#include <mongo/client/dbclientinterface.h>
 #include <mongo/util/exit_code.h>
 #include <mongo/util/net/hostandport.h>
+#include "robomongo/core/mongodb/MongoConnectionPool.h"
+#include "robomongo/core/settings/ConnectionSettings.h"
+#include "robomongo/core/utils/FormatUtils.h"
 
 namespace mongo {
     extern bool isShell;
@@ -37,6 +43,12 @@ void precisionAssert(const std::string &text, double d) {
         s << ".0";
     std::cout << "Checking " << text << " - ";
     assert(text == s.str());
+
+    std::string fast;
+    Robomongo::FormatUtils::appendDouble(fast, d);
+    if (d == (long long)d)
+        fast += ".0";
+    assert(text == fast);
     std::cout << "Correct. " << std::endl;
 }
 
@@ -66,11 +78,118 @@ void testPrecision() {
     precisionAssert("3.1415", 3.1415);
     precisionAssert("1.1", 1.1);
     precisionAssert("9.7", 9.7);
+    precisionAssert("0.0001", 0.0001);
+    precisionAssert("123456789012345.0", 123456789012345.0);
+    precisionAssert("1e+15.0", 1e15);
+    precisionAssert("1.5e-05", 0.000015);
+}
+
+void testFormatting() {
+    std::string s;
+    Robomongo::FormatUtils::appendInt(s, std::numeric_limits<long long>::min());
+    assert(s == "-9223372036854775808");
+
+    s.clear();
+    Robomongo::FormatUtils::appendUInt(s, 1234567890ULL);
+    assert(s == "1234567890");
+
+    s.clear();
+    Robomongo::FormatUtils::appendIsoDate(s, 0, true);
+    assert(s == "1970-01-01T00:00:00.000Z");
+
+    s.clear();
+    Robomongo::FormatUtils::appendIsoDate(s, -1, false);
+    assert(s == "1969-12-31 23:59:59.999Z");
+
+    s.clear();
+    Robomongo::FormatUtils::appendIsoDate(s, 951782400123LL, true);
+    assert(s == "2000-02-29T00:00:00.123Z");
+
+    s.clear();
+    Robomongo::FormatUtils::appendIsoDate(s, -9218988800000LL + 1, true);
+    assert(s == "1677-11-10T17:46:40.001Z");
+}
+
+// Pool, that does not open connections to server
+class TestConnectionPool : public Robomongo::MongoConnectionPool {
+protected:
+    virtual mongo::DBClientBase *connect(Robomongo::ConnectionSettings *settings, int timeoutSec, bool mayReturnNull) {
+        return new mongo::DBClientConnection(true);
+    }
+};
+
+void testConnectionPoolKeptCursors() {
+    Robomongo::ConnectionSettings settings;
+    settings.setMaxPoolSize(3);
+    TestConnectionPool pool;
+
+    // Connections of paging cursors, more than maximum size of pool
+    std::vector<mongo::DBClientBase *> cursors;
+    for (int i = 0; i < 5; ++i) {
+        mongo::DBClientBase *conn = pool.acquire(&settings, 0);
+        pool.keep(conn);
+        cursors.push_back(conn);
+    }
+
+    // Metadata request gets connection without waiting
+    std::vector<mongo::DBClientBase *> requests;
+    requests.push_back(pool.acquire(&settings, 0));
+    assert(requests.back());
+
+    // Other connections are still limited
+    requests.push_back(pool.acquire(&settings, 0));
+    requests.push_back(pool.acquire(&settings, 0));
+    bool isLimited = false;
+    try {
+        pool.acquire(&settings, 0);
+    } catch (const mongo::DBException &) {
+        isLimited = true;
+    }
+    assert(isLimited);
+
+    // Closed cursors do not take place of returned connections
+    for (size_t i = 0; i < cursors.size(); ++i)
+        pool.release(cursors[i]);
+    for (size_t i = 0; i < requests.size(); ++i)
+        pool.release(requests[i]);
+
+    for (int i = 0; i < 3; ++i)
+        requests[i] = pool.acquire(&settings, 0);
+    for (size_t i = 0; i < requests.size(); ++i)
+        pool.release(requests[i]);
+}
+
+void benchmarkFormatting() {
+    const int count = 1000000;
+    std::string output;
+    output.reserve(32 * count);
+
+    clock_t start = clock();
+    for (int i = 0; i < count; ++i) {
+        std::stringstream s;
+        s.precision(std::numeric_limits<double>::digits10);
+        s << i * 1.37;
+        output.append(s.str());
+    }
+    double streamSeconds = double(clock() - start) / CLOCKS_PER_SEC;
+
+    output.clear();
+    start = clock();
+    for (int i = 0; i < count; ++i) {
+        Robomongo::FormatUtils::appendDouble(output, i * 1.37);
+    }
+    double fastSeconds = double(clock() - start) / CLOCKS_PER_SEC;
+
+    std::cout << "Formatting of " << count << " doubles: stringstream " << streamSeconds
+              << " s, FormatUtils " << fastSeconds << " s" << std::endl;
 }
 
 int main(int argc, char *argv[], char** envp)
 {
     testHostAndPort();
     testPrecision();
+    testFormatting();
+    testConnectionPoolKeptCursors();
+    benchmarkFormatting();
     return 0;
 }
@@ -3,11 +3,15 @@
 #include "robomongo/core/EventBus.h"
 #include "robomongo/core/settings/SettingsManager.h"
 #include "robomongo/core/domain/App.h"
+#include "robomongo/core/mongodb/MongoConnectionPool.h"
+#include "robomongo/core/mongodb/WorkerThreadPool.h"
 
 namespace Robomongo
 {
     AppRegistry::AppRegistry() :
         _bus(new EventBus()),
+        _connectionPool(new MongoConnectionPool()),
+        _workerThreadPool(new WorkerThreadPool()),
         _settingsManager(new SettingsManager()),
         _app(new App(_bus.get()))
     {
@@ -15,12 +15,16 @@ namespace Robomongo
         SettingsManager *const settingsManager() const { return _settingsManager.get(); }
         App *const app() const { return _app.get(); }
         EventBus *const bus() const { return _bus.get(); }
+        MongoConnectionPool *const connectionPool() const { return _connectionPool.get(); }
+        WorkerThreadPool *const workerThreadPool() const { return _workerThreadPool.get(); }
 
     private:
         AppRegistry();
         ~AppRegistry();
 
         const EventBusScopedPtr _bus;
+        const MongoConnectionPoolScopedPtr _connectionPool;
+        const WorkerThreadPoolScopedPtr _workerThreadPool;
         const SettingsManagerScopedPtr _settingsManager;
         const AppScopedPtr _app;
     };
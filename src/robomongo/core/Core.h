@@ -25,12 +25,21 @@ namespace Robomongo
     class EventBus;
     typedef boost::scoped_ptr<EventBus> EventBusScopedPtr;
 
+    class MongoConnectionPool;
+    typedef boost::scoped_ptr<MongoConnectionPool> MongoConnectionPoolScopedPtr;
+
+    class WorkerThreadPool;
+    typedef boost::scoped_ptr<WorkerThreadPool> WorkerThreadPoolScopedPtr;
+
     class MongoCollection;
     typedef boost::shared_ptr<MongoCollection> MongoCollectionPtr;
 
     class MongoDocument;
     typedef boost::shared_ptr<MongoDocument> MongoDocumentPtr;
 
+    class ConnectionSettings;
+    typedef boost::shared_ptr<ConnectionSettings> ConnectionSettingsPtr;
+
     enum ConnectionType {
         // This type of connection is shown in Explorer and also
         // opens SSH tunnel for Secondary connections (if needed)
@@ -80,7 +80,7 @@ namespace Robomongo
             sendEvent(dis, new EventWrapper(event, theReceivers));
     }
 
-    void EventBus::send(QObject *receiver, Event *event)
+    void EventBus::send(QObject *receiver, Event *event, int priority /* = Qt::NormalEventPriority */)
     {
         QMutexLocker lock(&_lock);
 
@@ -90,7 +90,7 @@ namespace Robomongo
         QThread *thread = receiver->thread();
         EventBusDispatcher *dis = dispatcher(thread);
 
-        sendEvent(dis, new EventWrapper(event, receiver));
+        sendEvent(dis, new EventWrapper(event, receiver), priority);
     }
 
     void EventBus::send(QList<QObject *> receivers, Event *event)
@@ -152,14 +152,14 @@ namespace Robomongo
      * @brief Sends event synchronousely, if current thread and dispatcher thread are
      * the same. Sends asynchronousely, if this is cross-thread communication;
      */
-    void EventBus::sendEvent(EventBusDispatcher *dispatcher, EventWrapper *wrapper)
+    void EventBus::sendEvent(EventBusDispatcher *dispatcher, EventWrapper *wrapper, int priority /* = Qt::NormalEventPriority */)
     {
         if (dispatcher->thread() == QThread::currentThread()) {
             QCoreApplication::sendEvent(dispatcher, wrapper);
             delete wrapper;
         }
         else {
-            QCoreApplication::postEvent(dispatcher, wrapper);
+            QCoreApplication::postEvent(dispatcher, wrapper, priority);
         }
     }
 
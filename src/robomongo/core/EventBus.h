@@ -36,8 +36,10 @@ namespace Robomongo
 
         /**
          * @brief Sends 'event' to 'receiver'.
+         * @param priority - events with higher priority are delivered before
+         * events that are already waiting in the queue of receiver's thread.
          */
-        void send(QObject *receiver, Event *event);
+        void send(QObject *receiver, Event *event, int priority = Qt::NormalEventPriority);
 
         /**
          * @brief Sends 'event' to list of 'receivers'.
@@ -61,7 +63,7 @@ namespace Robomongo
          */
         EventBusDispatcher *dispatcher(QThread *thread);
 
-        void sendEvent(EventBusDispatcher *dispatcher, EventWrapper *wrapper);
+        void sendEvent(EventBusDispatcher *dispatcher, EventWrapper *wrapper, int priority = Qt::NormalEventPriority);
 
     private:
         QMutex _lock;
@@ -179,6 +179,7 @@ namespace Robomongo
             return;
 
         _shells.erase(it);
+        shell->closeQueryCursors();
         closeServer(shell->server());
         delete shell;
     }
@@ -0,0 +1,270 @@
+#include "robomongo/core/domain/MetadataCache.h"
+
+#include <set>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QCryptographicHash>
+#include <parser.h>
+#include <serializer.h>
+
+#include "robomongo/core/AppRegistry.h"
+#include "robomongo/core/settings/ConnectionSettings.h"
+#include "robomongo/core/settings/CredentialSettings.h"
+#include "robomongo/core/settings/SettingsManager.h"
+#include "robomongo/core/settings/SshSettings.h"
+#include "robomongo/core/utils/Logger.h"
+#include "robomongo/core/utils/QtUtils.h"
+
+namespace
+{
+    /**
+     * @brief Version of cache file. Files of other versions are ignored.
+     */
+    const int CacheVersion = 1;
+
+    /**
+     * @brief Name of cache file of connection. When SSH tunnel is used, settings
+     * contain local port of the tunnel, so SSH server is used instead.
+     */
+    QString cacheFileName(Robomongo::ConnectionSettings *settings)
+    {
+        std::string key = settings->connectionName();
+        Robomongo::SshSettings *ssh = settings->sshSettings();
+        if (ssh->enabled()) {
+            key += "|ssh:" + ssh->userName() + "@" + ssh->host() + ":" + Robomongo::QtUtils::toStdString(QString::number(ssh->port()));
+        } else {
+            key += "|" + settings->getFullAddress();
+        }
+
+        QList<Robomongo::CredentialSettings *> credentials = settings->credentials();
+        if (!credentials.isEmpty() && credentials.front()->enabled())
+            key += "|" + credentials.front()->userName() + "@" + credentials.front()->databaseName();
+
+        QByteArray hash = QCryptographicHash::hash(QByteArray(key.c_str(), key.size()), QCryptographicHash::Md5);
+        return QString::fromLatin1(hash.toHex()) + ".json";
+    }
+
+    QVariantList toVariantList(const std::vector<std::string> &names)
+    {
+        QVariantList list;
+        for (std::vector<std::string>::const_iterator it = names.begin(); it != names.end(); ++it)
+            list.append(Robomongo::QtUtils::toQString(*it));
+        return list;
+    }
+
+    std::vector<std::string> toStringVector(const QVariantList &list)
+    {
+        std::vector<std::string> names;
+        names.reserve(list.size());
+        for (QVariantList::const_iterator it = list.begin(); it != list.end(); ++it)
+            names.push_back(Robomongo::QtUtils::toStdString(it->toString()));
+        return names;
+    }
+
+    QVariantMap toVariant(const Robomongo::EnsureIndexInfo &info)
+    {
+        QVariantMap map;
+        map.insert("name", Robomongo::QtUtils::toQString(info._name));
+        map.insert("key", Robomongo::QtUtils::toQString(info._request));
+        map.insert("unique", info._unique);
+        map.insert("background", info._backGround);
+        map.insert("dropDups", info._dropDups);
+        map.insert("sparse", info._sparse);
+        map.insert("ttl", info._ttl);
+        map.insert("defaultLanguage", Robomongo::QtUtils::toQString(info._defaultLanguage));
+        map.insert("languageOverride", Robomongo::QtUtils::toQString(info._languageOverride));
+        map.insert("weights", Robomongo::QtUtils::toQString(info._textWeights));
+        return map;
+    }
+
+    Robomongo::EnsureIndexInfo fromVariant(const Robomongo::MongoCollectionInfo &collection, const QVariantMap &map)
+    {
+        using Robomongo::QtUtils::toStdString;
+        return Robomongo::EnsureIndexInfo(collection,
+            toStdString(map.value("name").toString()),
+            toStdString(map.value("key").toString()),
+            map.value("unique").toBool(),
+            map.value("background").toBool(),
+            map.value("dropDups").toBool(),
+            map.value("sparse").toBool(),
+            map.value("ttl", -1).toInt(),
+            toStdString(map.value("defaultLanguage").toString()),
+            toStdString(map.value("languageOverride").toString()),
+            toStdString(map.value("weights").toString()));
+    }
+}
+
+namespace Robomongo
+{
+    MetadataCache::MetadataCache(ConnectionSettings *settings) :
+        _path(QString("%1/cache/%2").arg(AppRegistry::instance().settingsManager()->configDir()).arg(cacheFileName(settings))),
+        _hasDatabases(false),
+        _isChanged(false)
+    {
+        load();
+    }
+
+    MetadataCache::~MetadataCache()
+    {
+        if (_isChanged)
+            save();
+    }
+
+    bool MetadataCache::databases(std::vector<std::string> &names) const
+    {
+        if (!_hasDatabases)
+            return false;
+
+        names = _databases;
+        return true;
+    }
+
+    void MetadataCache::setDatabases(const std::vector<std::string> &names)
+    {
+        if (_hasDatabases && _databases == names)
+            return;
+
+        _hasDatabases = true;
+        _databases = names;
+        _isChanged = true;
+        removeStale();
+    }
+
+    bool MetadataCache::collections(const std::string &database, std::vector<std::string> &names) const
+    {
+        CollectionsContainerType::const_iterator it = _collections.find(database);
+        if (it == _collections.end())
+            return false;
+
+        names = it->second;
+        return true;
+    }
+
+    void MetadataCache::setCollections(const std::string &database, const std::vector<std::string> &names)
+    {
+        CollectionsContainerType::iterator it = _collections.find(database);
+        if (it != _collections.end() && it->second == names)
+            return;
+
+        _collections[database] = names;
+        _isChanged = true;
+        removeStale();
+    }
+
+    bool MetadataCache::indexes(const MongoCollectionInfo &collection, std::vector<EnsureIndexInfo> &indexes) const
+    {
+        IndexesContainerType::const_iterator it = _indexes.find(collection.fullName());
+        if (it == _indexes.end())
+            return false;
+
+        indexes.clear();
+        for (QVariantList::const_iterator index = it->second.begin(); index != it->second.end(); ++index)
+            indexes.push_back(fromVariant(collection, index->toMap()));
+        return true;
+    }
+
+    void MetadataCache::setIndexes(const MongoNamespace &ns, const std::vector<EnsureIndexInfo> &indexes)
+    {
+        QVariantList list;
+        for (std::vector<EnsureIndexInfo>::const_iterator it = indexes.begin(); it != indexes.end(); ++it)
+            list.append(toVariant(*it));
+
+        IndexesContainerType::iterator it = _indexes.find(ns.toString());
+        if (it != _indexes.end() && it->second == list)
+            return;
+
+        _indexes[ns.toString()] = list;
+        _isChanged = true;
+    }
+
+    void MetadataCache::removeStale()
+    {
+        if (_hasDatabases) {
+            std::set<std::string> databases(_databases.begin(), _databases.end());
+            CollectionsContainerType::iterator it = _collections.begin();
+            while (it != _collections.end()) {
+                if (databases.find(it->first) == databases.end())
+                    _collections.erase(it++);
+                else
+                    ++it;
+            }
+        }
+
+        // Indexes are kept only for collections of cached databases
+        std::set<std::string> collections;
+        for (CollectionsContainerType::const_iterator it = _collections.begin(); it != _collections.end(); ++it)
+            collections.insert(it->second.begin(), it->second.end());
+
+        IndexesContainerType::iterator it = _indexes.begin();
+        while (it != _indexes.end()) {
+            if (collections.find(it->first) == collections.end())
+                _indexes.erase(it++);
+            else
+                ++it;
+        }
+    }
+
+    void MetadataCache::load()
+    {
+        QFile f(_path);
+        if (!f.open(QIODevice::ReadOnly))
+            return;
+
+        bool ok;
+        QJson::Parser parser;
+        QVariantMap map = parser.parse(f.readAll(), &ok).toMap();
+        if (!ok || map.value("version").toInt() != CacheVersion)
+            return;
+
+        if (map.contains("databases")) {
+            _hasDatabases = true;
+            _databases = toStringVector(map.value("databases").toList());
+        }
+
+        QVariantMap collections = map.value("collections").toMap();
+        for (QVariantMap::const_iterator it = collections.begin(); it != collections.end(); ++it)
+            _collections[QtUtils::toStdString(it.key())] = toStringVector(it.value().toList());
+
+        QVariantMap indexes = map.value("indexes").toMap();
+        for (QVariantMap::const_iterator it = indexes.begin(); it != indexes.end(); ++it)
+            _indexes[QtUtils::toStdString(it.key())] = it.value().toList();
+    }
+
+    bool MetadataCache::save()
+    {
+        QVariantMap map;
+        map.insert("version", CacheVersion);
+        if (_hasDatabases)
+            map.insert("databases", toVariantList(_databases));
+
+        QVariantMap collections;
+        for (CollectionsContainerType::const_iterator it = _collections.begin(); it != _collections.end(); ++it)
+            collections.insert(QtUtils::toQString(it->first), toVariantList(it->second));
+        map.insert("collections", collections);
+
+        QVariantMap indexes;
+        for (IndexesContainerType::const_iterator it = _indexes.begin(); it != _indexes.end(); ++it)
+            indexes.insert(QtUtils::toQString(it->first), it->second);
+        map.insert("indexes", indexes);
+
+        if (!QDir().mkpath(QFileInfo(_path).absolutePath())) {
+            LOG_MSG("ERROR: Could not create cache path: " + QFileInfo(_path).absolutePath(), mongo::logger::LogSeverity::Error());
+            return false;
+        }
+
+        QFile f(_path);
+        if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            LOG_MSG("ERROR: Could not write cache to: " + _path, mongo::logger::LogSeverity::Error());
+            return false;
+        }
+
+        bool ok;
+        QJson::Serializer s;
+        s.serialize(map, &f, &ok);
+        if (ok)
+            _isChanged = false;
+
+        return ok;
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QString>
+#include <QVariantList>
+#include <map>
+#include <vector>
+
+#include "robomongo/core/events/MongoEventsInfo.h"
+
+namespace Robomongo
+{
+    class ConnectionSettings;
+
+    /**
+     * @brief Names of databases and collections and indexes of collections,
+     *        that were loaded for connection last time. Explorer is shown from
+     *        this cache immediately and is revalidated with the server in the
+     *        background.
+     *
+     *        Cache of every connection is kept in its own file in the
+     *        "cache" directory near the config file. File is read on
+     *        construction and written on destruction, if it was changed.
+     *
+     * @threadsafe no
+     */
+    class MetadataCache
+    {
+    public:
+        explicit MetadataCache(ConnectionSettings *settings);
+        ~MetadataCache();
+
+        /**
+         * @brief Returns false, if there are no cached names
+         */
+        bool databases(std::vector<std::string> &names) const;
+        void setDatabases(const std::vector<std::string> &names);
+
+        /**
+         * @param names: full names of collections ("db.collection")
+         */
+        bool collections(const std::string &database, std::vector<std::string> &names) const;
+        void setCollections(const std::string &database, const std::vector<std::string> &names);
+
+        bool indexes(const MongoCollectionInfo &collection, std::vector<EnsureIndexInfo> &indexes) const;
+        void setIndexes(const MongoNamespace &ns, const std::vector<EnsureIndexInfo> &indexes);
+
+        /**
+         * @brief Writes cache to file
+         * @return true if success, false otherwise
+         */
+        bool save();
+
+    private:
+        typedef std::map<std::string, std::vector<std::string> > CollectionsContainerType;
+        typedef std::map<std::string, QVariantList> IndexesContainerType;
+
+        void load();
+
+        /**
+         * @brief Removes cached collections of databases that do not exist,
+         * and indexes of collections that do not exist.
+         */
+        void removeStale();
+
+        QString _path;
+        bool _hasDatabases;
+        std::vector<std::string> _databases;
+        CollectionsContainerType _collections;  // database -> full names of collections
+        IndexesContainerType _indexes;          // full name of collection -> indexes
+        bool _isChanged;
+    };
+}
@@ -18,13 +18,13 @@ namespace Robomongo
             _system = true;
     }
 
-/*    std::string MongoCollection::sizeString() const
+    QString MongoCollection::sizeString() const
     {
-        return MongoUtils::buildNiceSizeString(_info.sizeBytes()).toStdString();
+        return MongoUtils::buildNiceSizeString(_info.sizeBytes());
     }
 
     QString MongoCollection::storageSizeString() const
     {
         return MongoUtils::buildNiceSizeString(_info.storageSizeBytes());
-    }*/
+    }
 }
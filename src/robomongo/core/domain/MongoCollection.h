@@ -14,11 +14,12 @@ namespace Robomongo
 
         std::string name() const { return _ns.collectionName(); }
         const MongoCollectionInfo info() const { return _info; }
+        void setInfo(const MongoCollectionInfo &info) { _info = info; }
         std::string fullName() const { return _ns.toString(); }
         MongoDatabase *database() const { return _database; }
 
-//        std::string sizeString() const;
-//        QString storageSizeString() const;
+        QString sizeString() const;
+        QString storageSizeString() const;
 
     private:
 
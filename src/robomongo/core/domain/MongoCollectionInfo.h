@@ -7,32 +7,43 @@ namespace Robomongo
     class MongoCollectionInfo
     {
     public:
-        MongoCollectionInfo() {}
+        MongoCollectionInfo();
         MongoCollectionInfo(const std::string &ns);
-//        MongoCollectionInfo(mongo::BSONObj stats);
+
+        /**
+         * @brief Creates info from result of collStats command
+         */
+        MongoCollectionInfo(const std::string &ns, const mongo::BSONObj &stats);
 
         std::string name() const { return _ns.collectionName(); }
         std::string fullName() const { return _ns.toString(); }
         MongoNamespace ns() const { return _ns; }
 
+        /**
+         * @brief Statistics are loaded after the list of collections,
+         * this returns false until they are.
+         */
+        bool hasStats() const { return _hasStats; }
+
         /**
          * @brief Size in bytes
          * It is double, because db.stats()'s "size" field may be double
          * for large values, while Int32 for small.
          */
-//        double sizeBytes() const { return _sizeBytes; }
+        double sizeBytes() const { return _sizeBytes; }
 
         /**
          * @brief Storage size in bytes
          * It is double, because db.stats()'s "storageSize" field may be double
          * for large values, while Int32 for small.
          */
-//        double storageSizeBytes() const { return _storageSizeBytes; }
+        double storageSizeBytes() const { return _storageSizeBytes; }
 
-//        long long count() const { return _count; }
+        long long count() const { return _count; }
 
     private:
         MongoNamespace _ns;
+        bool _hasStats;
 
         /**
          * @brief Size in bytes
@@ -51,4 +62,3 @@ namespace Robomongo
         long long _count;
     };
 }
-
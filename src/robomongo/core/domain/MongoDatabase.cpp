@@ -2,6 +2,7 @@
 
 #include "robomongo/core/domain/MongoServer.h"
 #include "robomongo/core/domain/MongoCollection.h"
+#include "robomongo/core/domain/MetadataCache.h"
 #include "robomongo/core/mongodb/MongoWorker.h"
 #include "robomongo/core/AppRegistry.h"
 #include "robomongo/core/EventBus.h"
@@ -9,6 +10,7 @@
 namespace Robomongo
 {
     R_REGISTER_EVENT(MongoDatabaseCollectionListLoadedEvent)
+    R_REGISTER_EVENT(MongoDatabaseCollectionStatsLoadedEvent)
     R_REGISTER_EVENT(MongoDatabaseUsersLoadedEvent)
     R_REGISTER_EVENT(MongoDatabaseFunctionsLoadedEvent)
     R_REGISTER_EVENT(MongoDatabaseUsersLoadingEvent)
@@ -27,19 +29,48 @@ namespace Robomongo
         _system(name == "admin" || name == "local"),
         _server(server),
         _bus(AppRegistry::instance().bus()),
-        _name(name) {}
+        _name(name),
+        _isCollectionsLoaded(false) {}
 
     MongoDatabase::~MongoDatabase()
     {
+        // Database may be deleted by refresh, while statistics are loaded for it
+        if (_server->client())
+            _server->client()->cancelCollectionStats(this);
+
         clearCollections();
     }
 
     void MongoDatabase::loadCollections()
     {
+        // First load is shown from the cache of previous session, if any.
+        // List is revalidated with the server in the background.
+        std::vector<std::string> cached;
+        MetadataCache *cache = _server->metadataCache();
+        if (!_isCollectionsLoaded && cache && cache->collections(_name, cached)) {
+            std::vector<MongoCollectionInfo> infos(cached.begin(), cached.end());
+            updateCollections(infos);
+            _isCollectionsLoaded = true;
+            _bus->publish(new MongoDatabaseCollectionListLoadedEvent(this, _collections));
+        }
+
         _bus->publish(new MongoDatabaseCollectionsLoadingEvent(this));
         _bus->send(_server->client(), new LoadCollectionNamesRequest(this, _name));
     }
 
+    bool MongoDatabase::collectionNames(std::vector<std::string> &names) const
+    {
+        if (!_isCollectionsLoaded) {
+            MetadataCache *cache = _server->metadataCache();
+            return cache && cache->collections(_name, names);
+        }
+
+        names.clear();
+        for (std::vector<MongoCollection *>::const_iterator it = _collections.begin(); it != _collections.end(); ++it)
+            names.push_back((*it)->fullName());
+        return true;
+    }
+
     void MongoDatabase::loadUsers()
     {
         _bus->publish(new MongoDatabaseUsersLoadingEvent(this));
@@ -75,7 +106,7 @@ namespace Robomongo
 
     void MongoDatabase::copyCollection(MongoServer *server, const std::string &sourceDatabase, const std::string &collection)
     {
-        _bus->send(_server->client(), new CopyCollectionToDiffServerRequest(this, server->client(), sourceDatabase, collection, _name));
+        _bus->send(_server->client(), new CopyCollectionToDiffServerRequest(this, server->connectionRecord()->clone(), sourceDatabase, collection, _name));
     }
 
     void MongoDatabase::createUser(const MongoUser &user, bool overwrite)
@@ -110,15 +141,42 @@ namespace Robomongo
             return;
         }
 
-        clearCollections();
+        std::vector<std::string> namespaces;
         const std::vector<MongoCollectionInfo> &colectionsInfos = loaded->collectionInfos();
-        for (std::vector<MongoCollectionInfo>::const_iterator it = colectionsInfos.begin(); it != colectionsInfos.end(); ++it) {
-            const MongoCollectionInfo &info = *it;
-            MongoCollection *collection = new MongoCollection(this, info);
-            addCollection(collection);
-        }
+        for (std::vector<MongoCollectionInfo>::const_iterator it = colectionsInfos.begin(); it != colectionsInfos.end(); ++it)
+            namespaces.push_back(it->fullName());
 
+        if (MetadataCache *cache = _server->metadataCache())
+            cache->setCollections(_name, namespaces);
+
+        updateCollections(colectionsInfos);
+        _isCollectionsLoaded = true;
         _bus->publish(new MongoDatabaseCollectionListLoadedEvent(this, _collections));
+
+        // Names are shown first, counts and sizes arrive later
+        if (!namespaces.empty())
+            _bus->send(_server->client(), new LoadCollectionStatsRequest(this, _name, namespaces));
+    }
+
+    void MongoDatabase::handle(LoadCollectionStatsResponse *event)
+    {
+        if (event->isError())
+            return;
+
+        std::vector<MongoCollection *> updated;
+        const std::vector<MongoCollectionInfo> &infos = event->collectionInfos();
+        for (std::vector<MongoCollectionInfo>::const_iterator it = infos.begin(); it != infos.end(); ++it) {
+            // Statistics of collections that were removed by refresh are ignored
+            CollectionsByNameType::const_iterator found = _collectionsByName.find(it->fullName());
+            if (found == _collectionsByName.end())
+                continue;
+
+            found->second->setInfo(*it);
+            updated.push_back(found->second);
+        }
+
+        if (!updated.empty())
+            _bus->publish(new MongoDatabaseCollectionStatsLoadedEvent(this, updated));
     }
 
     void MongoDatabase::handle(CreateUserResponse *event)
@@ -152,11 +210,34 @@ namespace Robomongo
     {
         qDeleteAll(_collections);
         _collections.clear();
+        _collectionsByName.clear();
     }
 
-    void MongoDatabase::addCollection(MongoCollection *collection)
+    void MongoDatabase::updateCollections(const std::vector<MongoCollectionInfo> &infos)
     {
-        _collections.push_back(collection);
+        // Collections that are still in the database are kept, with their statistics
+        std::vector<MongoCollection *> collections;
+        CollectionsByNameType collectionsByName;
+        for (std::vector<MongoCollectionInfo>::const_iterator it = infos.begin(); it != infos.end(); ++it) {
+            MongoCollection *collection = NULL;
+            CollectionsByNameType::iterator found = _collectionsByName.find(it->fullName());
+            if (found != _collectionsByName.end()) {
+                collection = found->second;
+                _collectionsByName.erase(found);
+            } else {
+                collection = new MongoCollection(this, *it);
+            }
+
+            collections.push_back(collection);
+            collectionsByName[collection->fullName()] = collection;
+        }
+
+        // Left are collections that were removed
+        for (CollectionsByNameType::const_iterator it = _collectionsByName.begin(); it != _collectionsByName.end(); ++it)
+            delete it->second;
+
+        _collections.swap(collections);
+        _collectionsByName.swap(collectionsByName);
     }
 
     void MongoDatabase::handle(CreateCollectionResponse *event) {
@@ -167,6 +248,23 @@ namespace Robomongo
         genericResponseHandler(event, "Failed to drop collection.");
     }
 
+    void MongoDatabase::handle(DuplicateCollectionResponse *event) {
+        genericResponseHandler(event, "Failed to duplicate collection.");
+
+        // Copy may take long time, so counts and sizes are refreshed when it is finished
+        loadCollections();
+    }
+
+    void MongoDatabase::handle(CopyCollectionToDiffServerResponse *event) {
+        genericResponseHandler(event, "Failed to copy collection.");
+        loadCollections();
+    }
+
+    void MongoDatabase::handle(CopyCollectionProgressEvent *event) {
+        _bus->publish(new CopyCollectionProgressEvent(this, event->to(), event->documents(), event->bytes(),
+            event->documentsPerSec(), event->megabytesPerSec()));
+    }
+
     void MongoDatabase::genericResponseHandler(Event *event, const std::string &userFriendlyMessage) {
         if (!event->isError())
             return;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QObject>
+#include <map>
 #include <mongo/bson/bsonobj.h>
 
 #include "robomongo/core/Core.h"
@@ -79,25 +80,44 @@ namespace Robomongo
 
         MongoServer *server() const { return _server; }
 
+        /**
+         * @brief Full names of collections, loaded or cached in previous session
+         * @return false, if names are not known yet
+         */
+        bool collectionNames(std::vector<std::string> &names) const;
+
     protected Q_SLOTS:
         void handle(LoadCollectionNamesResponse *event);
+        void handle(LoadCollectionStatsResponse *event);
         void handle(LoadUsersResponse *event);
         void handle(LoadFunctionsResponse *event);
         void handle(CreateUserResponse *event);
         void handle(CreateCollectionResponse *event);
         void handle(DropCollectionResponse *event);
+        void handle(DuplicateCollectionResponse *event);
+        void handle(CopyCollectionToDiffServerResponse *event);
+        void handle(CopyCollectionProgressEvent *event);
 
     private:
         void clearCollections();
-        void addCollection(MongoCollection *collection);
+
+        /**
+         * @brief Brings list of collections in line with 'infos'. Collections
+         * that are still in the database are kept.
+         */
+        void updateCollections(const std::vector<MongoCollectionInfo> &infos);
         void genericResponseHandler(Event *event, const std::string &userFriendlyMessage);
 
     private:
+        typedef std::map<std::string, MongoCollection *> CollectionsByNameType;
+
         MongoServer *_server;
         std::vector<MongoCollection *> _collections;
+        CollectionsByNameType _collectionsByName;   // full name -> collection
         const std::string _name;
         const bool _system;
         EventBus *_bus;
+        bool _isCollectionsLoaded;  // list of collections was loaded from server or cache
     };
 
     class MongoDatabaseCollectionListLoadedEvent : public Event
@@ -114,6 +134,20 @@ namespace Robomongo
         std::vector<MongoCollection *> collections;
     };
 
+    /**
+     * @brief Statistics of some of loaded collections have arrived
+     */
+    class MongoDatabaseCollectionStatsLoadedEvent : public Event
+    {
+        R_EVENT
+
+        MongoDatabaseCollectionStatsLoadedEvent(QObject *sender, const std::vector<MongoCollection *> &list) :
+            Event(sender),
+            collections(list) { }
+
+        std::vector<MongoCollection *> collections;
+    };
+
     class MongoDatabaseUsersLoadedEvent : public Event
     {
         R_EVENT
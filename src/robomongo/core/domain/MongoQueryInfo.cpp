@@ -42,4 +42,20 @@ namespace Robomongo
         _options(options),
         _special(special)
         {}
+
+    mongo::BSONObj MongoQueryInfo::filter() const
+    {
+        if (!_special)
+            return _query;
+
+        return _query.getObjectField("query");
+    }
+
+    mongo::BSONObj MongoQueryInfo::sortOrder() const
+    {
+        if (!_special)
+            return mongo::BSONObj();
+
+        return _query.getObjectField("orderby");
+    }
 }
@@ -28,6 +28,16 @@ namespace Robomongo
                   mongo::BSONObj query, mongo::BSONObj fields, int limit, int skip, int batchSize,
                   int options, bool special);
 
+        /**
+         * @brief Query without special fields (like "orderby")
+         */
+        mongo::BSONObj filter() const;
+
+        /**
+         * @brief Sort order of the query, empty if query is not sorted
+         */
+        mongo::BSONObj sortOrder() const;
+
         CollectionInfo _info;
         mongo::BSONObj _query;
         mongo::BSONObj _fields;
@@ -37,6 +47,8 @@ namespace Robomongo
         int _options;
         bool _special; // flag, indicating that `query` contains special fields on
                       // first level, and query data in `query` field.
-        
+        mongo::BSONObj _boundary; // sort key of the last document on the previous page,
+                                  // if set, page can be loaded with range query instead of skip.
+
     };
 }
@@ -1,6 +1,9 @@
 #include "robomongo/core/domain/MongoServer.h"
 
+#include <sstream>
+
 #include "robomongo/core/domain/MongoDatabase.h"
+#include "robomongo/core/domain/MetadataCache.h"
 #include "robomongo/core/settings/ConnectionSettings.h"
 #include "robomongo/core/settings/SshSettings.h"
 #include "robomongo/core/settings/SettingsManager.h"
@@ -18,11 +21,17 @@ namespace Robomongo {
         _version(0.0f),
         _connectionType(connectionType),
         _client(NULL),
+        _metadataCache(NULL),
         _isConnected(false),
         _settings(settings),
         _handle(handle),
         _bus(AppRegistry::instance().bus()),
-        _app(AppRegistry::instance().app()) { }
+        _app(AppRegistry::instance().app())
+    {
+        // Only explorer of primary connection uses metadata
+        if (_connectionType == ConnectionPrimary)
+            _metadataCache = new MetadataCache(_settings);
+    }
 
     bool MongoServer::isConnected() const {
         return _isConnected;
@@ -41,9 +50,10 @@ namespace Robomongo {
 
         // MongoWorker "_client" does not deleted here, because it is now owned by
         // another thread (call to moveToThread() made in MongoWorker constructor).
-        // It will be deleted by this thread by means of "deleteLater()", which
-        // is also specified in MongoWorker constructor.
+        // It will be deleted by that thread by means of "deleteLater()", which
+        // is called in MongoWorker::stopAndDelete().
 
+        delete _metadataCache;
         delete _settings;
     }
 
@@ -52,7 +62,14 @@ namespace Robomongo {
      * @throws MongoException, if fails
      */
     void MongoServer::tryConnect() {
-        _bus->send(_client, new EstablishConnectionRequest(this, _connectionType));
+        // Cached databases are shown as soon as connection is established,
+        // connection does not wait for their names, loadDatabases() revalidates them
+        std::vector<std::string> names;
+        bool isCached = _metadataCache && _metadataCache->databases(names);
+        if (isCached)
+            updateDatabases(names);
+
+        _bus->send(_client, new EstablishConnectionRequest(this, _connectionType, !isCached));
     }
 
     QStringList MongoServer::getDatabasesNames() const {
@@ -83,14 +100,14 @@ namespace Robomongo {
     }
 
     void MongoServer::insertDocuments(const std::vector<mongo::BSONObj> &objCont,
-                                      const MongoNamespace &ns) {
-        for (std::vector<mongo::BSONObj>::const_iterator it = objCont.begin(); it != objCont.end(); it++) {
-            insertDocument(*it, ns);
-        }
+                                      const MongoNamespace &ns, bool ordered) {
+        _bus->send(_client, new InsertDocumentsRequest(this, objCont, ns, ordered), Qt::HighEventPriority);
     }
 
+    // Document edits are sent with the same priority as queries of result panes,
+    // so that refresh of the pane is executed after the edit
     void MongoServer::insertDocument(const mongo::BSONObj &obj, const MongoNamespace &ns) {
-        _bus->send(_client, new InsertDocumentRequest(this, obj, ns));
+        _bus->send(_client, new InsertDocumentRequest(this, obj, ns), Qt::HighEventPriority);
     }
 
     void MongoServer::saveDocuments(const std::vector<mongo::BSONObj> &objCont, const MongoNamespace &ns) {
@@ -100,14 +117,23 @@ namespace Robomongo {
     }
 
     void MongoServer::saveDocument(const mongo::BSONObj &obj, const MongoNamespace &ns) {
-        _bus->send(_client, new InsertDocumentRequest(this, obj, ns, true));
+        _bus->send(_client, new InsertDocumentRequest(this, obj, ns, true), Qt::HighEventPriority);
     }
 
     void MongoServer::removeDocuments(mongo::Query query, const MongoNamespace &ns, bool justOne) {
-        _bus->send(_client, new RemoveDocumentRequest(this, query, ns, justOne));
+        _bus->send(_client, new RemoveDocumentRequest(this, query, ns, justOne), Qt::HighEventPriority);
+    }
+
+    void MongoServer::removeDocumentsById(const std::vector<mongo::BSONObj> &ids, const MongoNamespace &ns) {
+        _bus->send(_client, new RemoveDocumentsByIdRequest(this, ids, ns), Qt::HighEventPriority);
     }
 
     void MongoServer::loadDatabases() {
+        // Databases that are already known (from connection or previous load)
+        // are shown at once, and the list is revalidated in the background
+        if (!_databases.isEmpty())
+            _bus->publish(new DatabaseListLoadedEvent(this, _databases));
+
         _bus->publish(new MongoServerLoadingDatabasesEvent(this));
         _bus->send(_client, new LoadDatabaseNamesRequest(this));
     }
@@ -117,8 +143,25 @@ namespace Robomongo {
         _databases.clear();
     }
 
-    void MongoServer::addDatabase(MongoDatabase *database) {
-        _databases.append(database);
+    void MongoServer::updateDatabases(const std::vector<std::string> &names) {
+        if (_metadataCache)
+            _metadataCache->setDatabases(names);
+
+        // Databases that are still on the server are kept with their collections
+        QList<MongoDatabase *> databases;
+        for (std::vector<std::string>::const_iterator it = names.begin(); it != names.end(); ++it) {
+            MongoDatabase *database = findDatabaseByName(*it);
+            if (!database)
+                database = new MongoDatabase(this, *it);
+            databases.append(database);
+        }
+
+        for (QList<MongoDatabase *>::const_iterator it = _databases.begin(); it != _databases.end(); ++it) {
+            if (!databases.contains(*it))
+                delete *it;
+        }
+
+        _databases = databases;
     }
 
     void MongoServer::handle(EstablishConnectionResponse *event) {
@@ -155,12 +198,9 @@ namespace Robomongo {
         if (_connectionType != ConnectionPrimary)
             return;
 
-        clearDatabases();
-        for (std::vector<std::string>::const_iterator it = info._databases.begin(); it != info._databases.end(); ++it) {
-            const std::string &name = *it;
-            MongoDatabase *db  = new MongoDatabase(this, name);
-            addDatabase(db);
-        }
+        // Databases are not loaded on connection, if they are cached
+        if (!info._databases.empty())
+            updateDatabases(info._databases);
     }
 
     void MongoServer::handle(LoadDatabaseNamesResponse *event) {
@@ -169,13 +209,7 @@ namespace Robomongo {
             return;
         }
 
-        clearDatabases();
-        for (std::vector<std::string>::iterator it = event->databaseNames.begin(); it != event->databaseNames.end(); ++it) {
-            const std::string &name = *it;
-            MongoDatabase *db  = new MongoDatabase(this, name);
-            addDatabase(db);
-        }
-
+        updateDatabases(event->databaseNames);
         _bus->publish(new DatabaseListLoadedEvent(this, _databases));
     }
 
@@ -183,7 +217,39 @@ namespace Robomongo {
         _bus->publish(new InsertDocumentResponse(event->sender(), event->error()));
     }
 
+    void MongoServer::handle(InsertDocumentsResponse *event) {
+        if (event->isError()) {
+            _bus->publish(new OperationFailedEvent(this, event->error().errorMessage(), "Failed to insert documents."));
+        } else if (!event->errors().empty() || !event->writeConcernError().empty()) {
+            std::stringstream details;
+            const std::vector<DocumentWriteError> &errors = event->errors();
+            for (std::vector<DocumentWriteError>::const_iterator it = errors.begin(); it != errors.end(); ++it) {
+                details << "Document #" << (it->_index + 1) << ": " << it->_message << std::endl;
+            }
+
+            if (!event->writeConcernError().empty())
+                details << "Write concern: " << event->writeConcernError() << std::endl;
+
+            std::stringstream message;
+            message << "Inserted " << event->insertedCount() << " document(s), ";
+            if (!errors.empty())
+                message << errors.size() << " document(s) failed.";
+            else
+                message << "but write concern is not satisfied.";
+            _bus->publish(new OperationFailedEvent(this, details.str(), message.str()));
+        }
+
+        // Result panes of the collection are refreshed once for all documents.
+        // Server is the sender, so panes of other servers are not refreshed.
+        _bus->publish(new InsertDocumentsResponse(this, event->ns(), event->insertedCount(), event->errors(),
+                                                  event->writeConcernError()));
+    }
+
     void MongoServer::handle(RemoveDocumentResponse *event) {
+        // Error is reported once here, every result view has its own Notifier
+        if (event->isError())
+            _bus->publish(new OperationFailedEvent(this, event->error().errorMessage(), "Failed to delete documents."));
+
         _bus->publish(new RemoveDocumentResponse(event->sender(), event->error()));
     }
 
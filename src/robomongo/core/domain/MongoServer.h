@@ -8,6 +8,7 @@ namespace Robomongo
 {
     class MongoWorker;
     class MongoDatabase;
+    class MetadataCache;
     class EventBus;
     class App;
 
@@ -51,11 +52,16 @@ namespace Robomongo
         QStringList getDatabasesNames() const;
         MongoDatabase *findDatabaseByName(const std::string &dbName) const;
 
-        void insertDocuments(const std::vector<mongo::BSONObj> &objCont, const MongoNamespace &ns);
+        /**
+         * @brief Inserts documents with single request. InsertDocumentsResponse
+         * is published when all documents are inserted.
+         */
+        void insertDocuments(const std::vector<mongo::BSONObj> &objCont, const MongoNamespace &ns, bool ordered = true);
         void insertDocument(const mongo::BSONObj &obj, const MongoNamespace &ns);
         void saveDocuments(const std::vector<mongo::BSONObj> &objCont, const MongoNamespace &ns);
         void saveDocument(const mongo::BSONObj &obj, const MongoNamespace &ns);
         void removeDocuments(mongo::Query query, const MongoNamespace &ns, bool justOne = true);
+        void removeDocumentsById(const std::vector<mongo::BSONObj> &ids, const MongoNamespace &ns);
         float version() const{ return _version; }
         const std::string& getStorageEngineType() const { return _storageEngineType; }
 
@@ -70,20 +76,32 @@ namespace Robomongo
         void loadDatabases();
         MongoWorker *const client() const { return _client; }
 
+        /**
+         * @brief Cached metadata of this connection. NULL if this is not a primary connection.
+         */
+        MetadataCache *metadataCache() const { return _metadataCache; }
+
     protected Q_SLOTS:
         void handle(EstablishConnectionResponse *event);
         void handle(LoadDatabaseNamesResponse *event);
         void handle(InsertDocumentResponse *event);
+        void handle(InsertDocumentsResponse *event);
         void handle(RemoveDocumentResponse *event);
         void handle(CreateDatabaseResponse *event);
         void handle(DropDatabaseResponse *event);
 
     private:
         void clearDatabases();
-        void addDatabase(MongoDatabase *database);
+
+        /**
+         * @brief Brings list of databases in line with 'names'. Databases that
+         * are still on the server are kept with their collections.
+         */
+        void updateDatabases(const std::vector<std::string> &names);
         void genericResponseHandler(Event *event, const std::string &userFriendlyMessage);
 
         MongoWorker *_client;
+        MetadataCache *_metadataCache;
         ConnectionSettings *_settings;
         EventBus *_bus;
         App *_app;
@@ -22,6 +22,7 @@ namespace Robomongo
 
     void MongoShell::open(const std::string &script, const std::string &dbName)
     {
+        closeQueryCursors();
         AppRegistry::instance().bus()->publish(new ScriptExecutingEvent(this));
         _scriptInfo.setScript(QtUtils::toQString(script));
         AppRegistry::instance().bus()->send(_server->client(), new ExecuteScriptRequest(this, query(), dbName));
@@ -35,6 +36,7 @@ namespace Robomongo
 
     void MongoShell::execute(const std::string &dbName)
     {
+        closeQueryCursors();
         if (_scriptInfo.execute()) {
             AppRegistry::instance().bus()->publish(new ScriptExecutingEvent(this));
             AppRegistry::instance().bus()->send(_server->client(), new ExecuteScriptRequest(this, query(), dbName));
@@ -49,7 +51,13 @@ namespace Robomongo
 
     void MongoShell::query(int resultIndex, const MongoQueryInfo &info)
     {
-        AppRegistry::instance().bus()->send(_server->client(), new ExecuteQueryRequest(this, resultIndex, info));
+        // Paging is interactive, it goes ahead of explorer loads queued for this server
+        AppRegistry::instance().bus()->send(_server->client(), new ExecuteQueryRequest(this, resultIndex, info), Qt::HighEventPriority);
+    }
+
+    void MongoShell::closeQueryCursors()
+    {
+        AppRegistry::instance().bus()->send(_server->client(), new CloseQueryCursorsRequest(this), Qt::HighEventPriority);
     }
 
     void MongoShell::autocomplete(const std::string &prefix)
@@ -88,7 +96,8 @@ namespace Robomongo
             return;
         }
 
-        AppRegistry::instance().bus()->publish(new DocumentListLoadedEvent(this, event->resultIndex, event->queryInfo, query(), event->documents));
+        AppRegistry::instance().bus()->publish(new DocumentListLoadedEvent(this, event->resultIndex, event->queryInfo, query(), event->documents,
+                                                                             event->firstBatch, event->lastBatch));
     }
 
     void MongoShell::handle(ExecuteScriptResponse *event)
@@ -14,6 +14,11 @@ namespace Robomongo
 
         void open(const std::string &script, const std::string &dbName = std::string());
         void query(int resultIndex, const MongoQueryInfo &info);
+
+        /**
+         * @brief Kill server cursors kept for paging of current results
+         */
+        void closeQueryCursors();
         void autocomplete(const std::string &prefix);
         void stop();
         MongoServer *server() const { return _server; }
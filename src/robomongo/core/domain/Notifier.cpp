@@ -93,6 +93,7 @@ namespace Robomongo
     {
         QWidget *wid = dynamic_cast<QWidget*>(_observer);
         AppRegistry::instance().bus()->subscribe(this, InsertDocumentResponse::Type);
+        AppRegistry::instance().bus()->subscribe(this, InsertDocumentsResponse::Type);
         AppRegistry::instance().bus()->subscribe(this, RemoveDocumentResponse::Type);
 
         _deleteDocumentAction = new QAction("Delete Document...", wid);
@@ -158,7 +159,8 @@ namespace Robomongo
 
     void Notifier::deleteDocuments(std::vector<BsonTreeItem*> items, bool force)
     {
-        bool isNeededRefresh = false;
+        // All selected documents are removed with one request
+        std::vector<mongo::BSONObj> ids;
         for (std::vector<BsonTreeItem*>::const_iterator it = items.begin(); it != items.end(); ++it) {
             BsonTreeItem * documentItem = *it;
             if (!documentItem)
@@ -175,8 +177,6 @@ namespace Robomongo
 
             mongo::BSONObjBuilder builder;
             builder.append(id);
-            mongo::BSONObj bsonQuery = builder.obj();
-            mongo::Query query(bsonQuery);
 
             if (!force) {
                 // Ask user
@@ -187,12 +187,14 @@ namespace Robomongo
                     break;
             }
 
-            isNeededRefresh = true;
-            _shell->server()->removeDocuments(query, _queryInfo._info._ns);
+            ids.push_back(builder.obj());
         }
 
-        if (isNeededRefresh)
-            _shell->query(0, _queryInfo);
+        if (ids.empty())
+            return;
+
+        _shell->server()->removeDocumentsById(ids, _queryInfo._info._ns);
+        _shell->query(0, _queryInfo);
     }
 
     void Notifier::handle(InsertDocumentResponse *event)
@@ -205,18 +207,24 @@ namespace Robomongo
         _shell->query(0, _queryInfo);
     }
 
-    void Notifier::handle(RemoveDocumentResponse *event)
+    void Notifier::handle(InsertDocumentsResponse *event)
     {
-        if (event->isError()) {
-            // Commented because when you'll delete multiple documents,
-            // we'll receive this event as many times as many selected
-            // documents you have. This is incorrect and remove of
-            // multiple documents should be a single command, instead
-            // of many. Error message should be printed in the logs.
+        // Errors are reported by MongoServer, that publishes this response.
+        // Collection with the same name may exist on other servers.
+        if (event->sender() != _shell->server() || event->ns().toString() != _queryInfo._info._ns.toString())
+            return;
 
-            // QMessageBox::warning(NULL, "Database Error", QString::fromStdString(event->error().errorMessage()));
+        // Unacknowledged inserts (w: 0) do not return number of inserted documents
+        if (event->isError())
             return;
-        }
+
+        _shell->query(0, _queryInfo);
+    }
+
+    void Notifier::handle(RemoveDocumentResponse *event)
+    {
+        // Errors are reported by MongoServer, that publishes this response.
+        // Every result view has its own Notifier, so they are not shown here.
     }
 
     void Notifier::handleDeleteCommand()
@@ -335,12 +343,8 @@ namespace Robomongo
         if (result != QDialog::Accepted)
             return;
 
-        DocumentTextEditor::ReturnType obj = editor.bsonObj();
-        for (DocumentTextEditor::ReturnType::const_iterator it = obj.begin(); it != obj.end(); ++it) {
-            _shell->server()->insertDocument(*it, _queryInfo._info._ns);
-        }
-
-        _shell->query(0, _queryInfo);
+        // Pane is refreshed when InsertDocumentsResponse is received
+        _shell->server()->insertDocuments(editor.bsonObj(), _queryInfo._info._ns);
     }
 
     void Notifier::onCopyDocument()
@@ -14,6 +14,7 @@ namespace Robomongo
     class MongoShell;
     class BsonTreeItem;
     class InsertDocumentResponse;
+    class InsertDocumentsResponse;
     class RemoveDocumentResponse;
 
     namespace detail
@@ -58,6 +59,7 @@ namespace Robomongo
         void onCopyTimestamp();
         void onCopyJson();
         void handle(InsertDocumentResponse *event);
+        void handle(InsertDocumentsResponse *event);
         void handle(RemoveDocumentResponse *event);
 
     private:
@@ -9,6 +9,8 @@ namespace Robomongo
     R_REGISTER_EVENT(LoadDatabaseNamesResponse)
     R_REGISTER_EVENT(LoadCollectionNamesRequest)
     R_REGISTER_EVENT(LoadCollectionNamesResponse)
+    R_REGISTER_EVENT(LoadCollectionStatsRequest)
+    R_REGISTER_EVENT(LoadCollectionStatsResponse)
     R_REGISTER_EVENT(LoadUsersRequest)
     R_REGISTER_EVENT(LoadCollectionIndexesRequest)
     R_REGISTER_EVENT(LoadCollectionIndexesResponse)
@@ -26,6 +28,7 @@ namespace Robomongo
     R_REGISTER_EVENT(OpeningShellEvent)
     R_REGISTER_EVENT(ExecuteQueryRequest)
     R_REGISTER_EVENT(ExecuteQueryResponse)
+    R_REGISTER_EVENT(CloseQueryCursorsRequest)
     R_REGISTER_EVENT(DocumentListLoadedEvent)
     R_REGISTER_EVENT(ExecuteScriptRequest)
     R_REGISTER_EVENT(ExecuteScriptResponse)
@@ -35,7 +38,10 @@ namespace Robomongo
     R_REGISTER_EVENT(ScriptExecutingEvent)
     R_REGISTER_EVENT(InsertDocumentRequest)
     R_REGISTER_EVENT(InsertDocumentResponse)
+    R_REGISTER_EVENT(InsertDocumentsRequest)
+    R_REGISTER_EVENT(InsertDocumentsResponse)
     R_REGISTER_EVENT(RemoveDocumentRequest)
+    R_REGISTER_EVENT(RemoveDocumentsByIdRequest)
     R_REGISTER_EVENT(RemoveDocumentResponse)
     R_REGISTER_EVENT(CreateDatabaseRequest)
     R_REGISTER_EVENT(CreateDatabaseResponse)
@@ -51,6 +57,7 @@ namespace Robomongo
     R_REGISTER_EVENT(DuplicateCollectionResponse)
     R_REGISTER_EVENT(CopyCollectionToDiffServerRequest)
     R_REGISTER_EVENT(CopyCollectionToDiffServerResponse)
+    R_REGISTER_EVENT(CopyCollectionProgressEvent)
     R_REGISTER_EVENT(CreateUserRequest)
     R_REGISTER_EVENT(CreateUserResponse)
     R_REGISTER_EVENT(DropUserRequest)
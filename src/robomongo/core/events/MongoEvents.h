@@ -30,11 +30,18 @@ namespace Robomongo
     {
         R_EVENT
 
-        EstablishConnectionRequest(QObject *sender, ConnectionType connectionType) :
+        EstablishConnectionRequest(QObject *sender, ConnectionType connectionType, bool loadDatabases = true) :
             Event(sender),
-            connectionType(connectionType) {}
+            connectionType(connectionType),
+            loadDatabases(loadDatabases) {}
 
         ConnectionType connectionType;
+
+        /**
+         * @brief False, if databases are already known (e.g. from cache). Names of
+         * databases are not loaded then, ConnectionInfo has no databases.
+         */
+        bool loadDatabases;
     };
 
     class EstablishConnectionResponse : public Event
@@ -134,6 +141,48 @@ namespace Robomongo
         std::vector<MongoCollectionInfo> _collectionInfos;
     };
 
+    /**
+     * @brief Loads statistics of collections in the background,
+     * after their names are shown. Every LoadCollectionStatsResponse
+     * carries statistics of some of 'namespaces'.
+     */
+    class LoadCollectionStatsRequest : public Event
+    {
+        R_EVENT
+
+    public:
+        LoadCollectionStatsRequest(QObject *sender, const std::string &databaseName,
+                                   const std::vector<std::string> &namespaces) :
+            Event(sender),
+            _databaseName(databaseName),
+            _namespaces(namespaces) {}
+
+        std::string databaseName() const { return _databaseName; }
+        std::vector<std::string> namespaces() const { return _namespaces; }
+
+    private:
+        std::string _databaseName;
+        std::vector<std::string> _namespaces;
+    };
+
+    class LoadCollectionStatsResponse : public Event
+    {
+        R_EVENT
+
+    public:
+        LoadCollectionStatsResponse(QObject *sender, const std::vector<MongoCollectionInfo> &collectionInfos) :
+            Event(sender),
+            _collectionInfos(collectionInfos) {}
+
+        LoadCollectionStatsResponse(QObject *sender, const EventError &error) :
+            Event(sender, error) {}
+
+        std::vector<MongoCollectionInfo> collectionInfos() const { return _collectionInfos; }
+
+    private:
+        std::vector<MongoCollectionInfo> _collectionInfos;
+    };
+
     class LoadCollectionIndexesRequest : public Event
     {
         R_EVENT
@@ -344,6 +393,66 @@ namespace Robomongo
             Event(sender, error) {}
     };
 
+    /**
+     * @brief Insert several documents with batched writes.
+     * @param ordered: stop at the first failed document
+     */
+
+    class InsertDocumentsRequest : public Event
+    {
+        R_EVENT
+
+    public:
+        InsertDocumentsRequest(QObject *sender, const std::vector<mongo::BSONObj> &objs, const MongoNamespace &ns, bool ordered = true) :
+            Event(sender),
+            _objs(objs),
+            _ns(ns),
+            _ordered(ordered) {}
+
+        const std::vector<mongo::BSONObj> &objs() const { return _objs; }
+        MongoNamespace ns() const { return _ns; }
+        bool ordered() const { return _ordered; }
+
+    private:
+        const std::vector<mongo::BSONObj> _objs;
+        const MongoNamespace _ns;
+        const bool _ordered;
+    };
+
+    class InsertDocumentsResponse : public Event
+    {
+        R_EVENT
+
+    public:
+        InsertDocumentsResponse(QObject *sender, const MongoNamespace &ns, int insertedCount,
+            const std::vector<DocumentWriteError> &errors, const std::string &writeConcernError = std::string()) :
+            Event(sender),
+            _ns(ns),
+            _insertedCount(insertedCount),
+            _errors(errors),
+            _writeConcernError(writeConcernError) {}
+
+        InsertDocumentsResponse(QObject *sender, const MongoNamespace &ns, const EventError &error) :
+            Event(sender, error),
+            _ns(ns),
+            _insertedCount(0) {}
+
+        MongoNamespace ns() const { return _ns; }
+        int insertedCount() const { return _insertedCount; }
+        const std::vector<DocumentWriteError> &errors() const { return _errors; }
+
+        /**
+         * @brief Documents are inserted, but write concern is not satisfied
+         */
+        const std::string &writeConcernError() const { return _writeConcernError; }
+
+    private:
+        const MongoNamespace _ns;
+        const int _insertedCount;
+        const std::vector<DocumentWriteError> _errors;
+        const std::string _writeConcernError;
+    };
+
     /**
      * @brief Remove Document
      */
@@ -369,6 +478,29 @@ namespace Robomongo
         bool _justOne;
     };
 
+    /**
+     * @brief Remove documents with specified _id values.
+     * @param ids: objects with single _id field
+     */
+
+    class RemoveDocumentsByIdRequest : public Event
+    {
+        R_EVENT
+
+    public:
+        RemoveDocumentsByIdRequest(QObject *sender, const std::vector<mongo::BSONObj> &ids, const MongoNamespace &ns) :
+            Event(sender),
+            _ids(ids),
+            _ns(ns) {}
+
+        const std::vector<mongo::BSONObj> &ids() const { return _ids; }
+        MongoNamespace ns() const { return _ns; }
+
+    private:
+        const std::vector<mongo::BSONObj> _ids;
+        const MongoNamespace _ns;
+    };
+
     class RemoveDocumentResponse : public Event
     {
         R_EVENT
@@ -599,18 +731,22 @@ namespace Robomongo
         R_EVENT
 
     public:
-        CopyCollectionToDiffServerRequest(QObject *sender, MongoWorker *worker, const std::string &databaseFrom,
+        /**
+         * @param sourceSettings: copy of settings of source server, owned by request.
+         * Source server may be disconnected while collection is copied.
+         */
+        CopyCollectionToDiffServerRequest(QObject *sender, ConnectionSettings *sourceSettings, const std::string &databaseFrom,
             const std::string &collection, const std::string &databaseTo) :
         Event(sender),
-            _worker(worker),
+            _sourceSettings(sourceSettings),
             _from(databaseFrom, collection),
             _to(databaseTo, collection) {}
 
-        MongoWorker *worker() const { return _worker; }
+        ConnectionSettings *sourceSettings() const { return _sourceSettings.get(); }
         MongoNamespace from() const { return _from; }
         MongoNamespace to() const { return _to; }
     private:
-        MongoWorker *_worker;
+        ConnectionSettingsPtr _sourceSettings;
         const MongoNamespace _from;
         const MongoNamespace _to;
     };
@@ -627,6 +763,38 @@ namespace Robomongo
             Event(sender, error) {}
     };
 
+    /**
+     * @brief Progress of duplicate/copy collection operation
+     */
+
+    class CopyCollectionProgressEvent : public Event
+    {
+        R_EVENT
+
+    public:
+        CopyCollectionProgressEvent(QObject *sender, const MongoNamespace &to, long long documents,
+            long long bytes, double documentsPerSec, double megabytesPerSec) :
+            Event(sender),
+            _to(to),
+            _documents(documents),
+            _bytes(bytes),
+            _documentsPerSec(documentsPerSec),
+            _megabytesPerSec(megabytesPerSec) {}
+
+        MongoNamespace to() const { return _to; }
+        long long documents() const { return _documents; }
+        long long bytes() const { return _bytes; }
+        double documentsPerSec() const { return _documentsPerSec; }
+        double megabytesPerSec() const { return _megabytesPerSec; }
+
+    private:
+        const MongoNamespace _to;
+        const long long _documents;
+        const long long _bytes;
+        const double _documentsPerSec;
+        const double _megabytesPerSec;
+    };
+
     /**
      * @brief Create User
      */
@@ -802,18 +970,41 @@ namespace Robomongo
     {
         R_EVENT
 
-        ExecuteQueryResponse(QObject *sender, int resultIndex, const MongoQueryInfo &queryInfo, const std::vector<MongoDocumentPtr> &documents) :
+        /**
+         * @brief Query results are sent batch by batch, as they are received
+         * from cursor. First batch replaces previous results, next ones are appended.
+         */
+        ExecuteQueryResponse(QObject *sender, int resultIndex, const MongoQueryInfo &queryInfo, const std::vector<MongoDocumentPtr> &documents,
+                             bool firstBatch = true, bool lastBatch = true) :
             Event(sender),
             resultIndex(resultIndex),
             queryInfo(queryInfo),
-            documents(documents) { }
+            documents(documents),
+            firstBatch(firstBatch),
+            lastBatch(lastBatch) { }
 
         ExecuteQueryResponse(QObject *sender, const EventError &error) :
-            Event(sender, error) {}
+            Event(sender, error),
+            firstBatch(true),
+            lastBatch(true) {}
 
         int resultIndex;
         MongoQueryInfo queryInfo;
         std::vector<MongoDocumentPtr> documents;
+        bool firstBatch;
+        bool lastBatch;
+    };
+
+    /**
+     * @brief Kill server cursors kept open for paging of results of 'sender'
+     */
+    class CloseQueryCursorsRequest : public Event
+    {
+        R_EVENT
+
+    public:
+        CloseQueryCursorsRequest(QObject *sender) :
+            Event(sender) {}
     };
 
     class AutocompleteRequest : public Event
@@ -961,26 +1152,35 @@ namespace Robomongo
         R_EVENT
 
     public:
-        DocumentListLoadedEvent(QObject *sender, int resultIndex, const MongoQueryInfo &queryInfo, const std::string &query, const std::vector<MongoDocumentPtr> &docs) :
+        DocumentListLoadedEvent(QObject *sender, int resultIndex, const MongoQueryInfo &queryInfo, const std::string &query, const std::vector<MongoDocumentPtr> &docs,
+                                bool firstBatch = true, bool lastBatch = true) :
             Event(sender),
             _resultIndex(resultIndex),
             _queryInfo(queryInfo),
             _query(query),
-            _documents(docs) { }
+            _documents(docs),
+            _firstBatch(firstBatch),
+            _lastBatch(lastBatch) { }
 
         DocumentListLoadedEvent(QObject *sender, const EventError &error) :
-            Event(sender, error) {}
+            Event(sender, error),
+            _firstBatch(true),
+            _lastBatch(true) {}
 
         int resultIndex() const { return _resultIndex; }
         MongoQueryInfo queryInfo() const { return _queryInfo; }
         std::vector<MongoDocumentPtr> documents() const { return _documents; }
         std::string query() const { return _query; }
+        bool firstBatch() const { return _firstBatch; }
+        bool lastBatch() const { return _lastBatch; }
 
     private:
         int _resultIndex;
         MongoQueryInfo _queryInfo;
         std::vector<MongoDocumentPtr> _documents;
         std::string _query;
+        bool _firstBatch;
+        bool _lastBatch;
     };
 
     class ScriptExecutedEvent : public Event
@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include <vector>
 #include "robomongo/core/domain/MongoCollectionInfo.h"
 
 namespace Robomongo
@@ -32,6 +33,19 @@ namespace Robomongo
         std::string _textWeights;
     };
 
+    /**
+     * @brief Error of single document in bulk write
+     */
+    struct DocumentWriteError
+    {
+        DocumentWriteError(int index, const std::string &message) :
+            _index(index),
+            _message(message) {}
+
+        int _index;             // index of document in request
+        std::string _message;
+    };
+
     struct ConnectionInfo
     {
         ConnectionInfo();
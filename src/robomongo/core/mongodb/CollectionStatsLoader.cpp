@@ -0,0 +1,188 @@
+#include "robomongo/core/mongodb/CollectionStatsLoader.h"
+
+#include <QThread>
+#include <QDateTime>
+
+#include "robomongo/core/EventBus.h"
+#include "robomongo/core/AppRegistry.h"
+#include "robomongo/core/events/MongoEvents.h"
+#include "robomongo/core/mongodb/MongoClient.h"
+#include "robomongo/core/mongodb/MongoConnectionPool.h"
+#include "robomongo/core/settings/ConnectionSettings.h"
+#include "robomongo/core/utils/Logger.h"
+
+namespace Robomongo
+{
+    class CollectionStatsLoader::Fetcher : public QThread
+    {
+    public:
+        Fetcher(CollectionStatsLoader *loader, int index) :
+            _loader(loader),
+            _index(index) {}
+
+    protected:
+        virtual void run()
+        {
+            _loader->fetch(_index);
+        }
+
+    private:
+        CollectionStatsLoader *const _loader;
+        const int _index;
+    };
+
+    CollectionStatsLoader::CollectionStatsLoader(ConnectionSettings *connection, int mongoTimeoutSec) :
+        _isCancelled(false),
+        _connection(connection),
+        _mongoTimeoutSec(mongoTimeoutSec)
+    {
+        for (int i = 0; i < maxConcurrency; ++i) {
+            _fetchers.push_back(new Fetcher(this, i));
+            _isFetching.push_back(false);
+            _fetchingReceivers.push_back(NULL);
+        }
+    }
+
+    CollectionStatsLoader::~CollectionStatsLoader()
+    {
+        cancel();
+
+        for (std::vector<Fetcher *>::iterator it = _fetchers.begin(); it != _fetchers.end(); ++it) {
+            (*it)->wait();
+            delete *it;
+        }
+
+        delete _connection;
+    }
+
+    void CollectionStatsLoader::load(QObject *sender, QObject *receiver, const std::vector<std::string> &namespaces)
+    {
+        QMutexLocker lock(&_lock);
+        if (_isCancelled)
+            return;
+
+        // Namespaces of the previous load are queued again below, if still needed
+        std::deque<Job> queue;
+        for (std::deque<Job>::const_iterator it = _queue.begin(); it != _queue.end(); ++it) {
+            if (it->receiver != receiver)
+                queue.push_back(*it);
+        }
+        _queue.swap(queue);
+
+        const qint64 now = QDateTime::currentMSecsSinceEpoch();
+        std::vector<MongoCollectionInfo> cached;
+        for (std::vector<std::string>::const_iterator it = namespaces.begin(); it != namespaces.end(); ++it) {
+            std::map<std::string, CachedStats>::const_iterator found = _cache.find(*it);
+            if (found != _cache.end() && now - found->second.loadedMs < cacheTtlMs) {
+                cached.push_back(found->second.info);
+                continue;
+            }
+
+            Job job;
+            job.sender = sender;
+            job.receiver = receiver;
+            job.ns = *it;
+            _queue.push_back(job);
+        }
+
+        if (!cached.empty())
+            send(receiver, new LoadCollectionStatsResponse(sender, cached));
+
+        startFetchers();
+    }
+
+    void CollectionStatsLoader::invalidate(const std::string &ns)
+    {
+        QMutexLocker lock(&_lock);
+        _cache.erase(ns);
+    }
+
+    void CollectionStatsLoader::cancel()
+    {
+        QMutexLocker lock(&_lock);
+        _isCancelled = true;
+        _queue.clear();
+    }
+
+    void CollectionStatsLoader::cancel(QObject *receiver)
+    {
+        QMutexLocker lock(&_lock);
+
+        std::deque<Job> queue;
+        for (std::deque<Job>::const_iterator it = _queue.begin(); it != _queue.end(); ++it) {
+            if (it->receiver != receiver)
+                queue.push_back(*it);
+        }
+        _queue.swap(queue);
+
+        for (size_t i = 0; i < _fetchingReceivers.size(); ++i) {
+            if (_fetchingReceivers[i] == receiver)
+                _fetchingReceivers[i] = NULL;
+        }
+    }
+
+    void CollectionStatsLoader::startFetchers()
+    {
+        int fetching = 0;
+        for (size_t i = 0; i < _isFetching.size(); ++i) {
+            if (_isFetching[i])
+                ++fetching;
+        }
+
+        for (size_t i = 0; i < _fetchers.size() && fetching < static_cast<int>(_queue.size()); ++i) {
+            if (_isFetching[i])
+                continue;
+
+            // Fetcher has left fetch() and does not take the lock anymore,
+            // so waiting for the end of its thread is short
+            _fetchers[i]->wait();
+            _isFetching[i] = true;
+            _fetchers[i]->start();
+            ++fetching;
+        }
+    }
+
+    void CollectionStatsLoader::fetch(int index)
+    {
+        MongoConnectionPool *pool = AppRegistry::instance().connectionPool();
+
+        while (true) {
+            Job job;
+            {
+                QMutexLocker lock(&_lock);
+                _fetchingReceivers[index] = NULL;
+                if (_queue.empty() || _isCancelled) {
+                    _isFetching[index] = false;
+                    return;
+                }
+
+                job = _queue.front();
+                _queue.pop_front();
+                _fetchingReceivers[index] = job.receiver;
+            }
+
+            try {
+                boost::scoped_ptr<MongoClient> client(new MongoClient(pool->acquire(_connection, _mongoTimeoutSec), pool));
+                MongoCollectionInfo info = client->runCollStatsCommand(job.ns);
+                client->done();
+
+                QMutexLocker lock(&_lock);
+                CachedStats &cached = _cache[job.ns];
+                cached.info = info;
+                cached.loadedMs = QDateTime::currentMSecsSinceEpoch();
+
+                // Receiver may be deleted while statistics were fetched
+                if (!_isCancelled && _fetchingReceivers[index] == job.receiver)
+                    send(job.receiver, new LoadCollectionStatsResponse(job.sender, std::vector<MongoCollectionInfo>(1, info)));
+            } catch(const mongo::DBException &ex) {
+                // Collection is shown without statistics (e.g. user is not authorized for collStats)
+                LOG_MSG(ex.what(), mongo::logger::LogSeverity::Error());
+            }
+        }
+    }
+
+    void CollectionStatsLoader::send(QObject *receiver, Event *event)
+    {
+        AppRegistry::instance().bus()->send(receiver, event);
+    }
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <QObject>
+#include <QMutex>
+#include <deque>
+#include <map>
+#include <vector>
+
+#include "robomongo/core/domain/MongoCollectionInfo.h"
+
+namespace Robomongo
+{
+    class ConnectionSettings;
+    class Event;
+
+    /**
+     * @brief Loads statistics of collections (collStats) for the explorer.
+     *        Namespaces are queued and fetched by not more than
+     *        maxConcurrency threads, each with its own connection from
+     *        MongoConnectionPool. Every result is sent to the receiver as
+     *        LoadCollectionStatsResponse as soon as it arrives, and is cached
+     *        for cacheTtlMs, so refresh of the explorer does not load it again.
+     *
+     *        Methods are thread-safe. Fetching threads are started on demand
+     *        and finish when the queue is empty.
+     */
+    class CollectionStatsLoader
+    {
+    public:
+        enum { maxConcurrency = 3, cacheTtlMs = 60 * 1000 };
+
+        /**
+         * @param connection: CollectionStatsLoader takes ownership of this settings.
+         */
+        CollectionStatsLoader(ConnectionSettings *connection, int mongoTimeoutSec);
+
+        /**
+         * @brief Waits for statistics that are being fetched now
+         */
+        ~CollectionStatsLoader();
+
+        /**
+         * @brief Sends cached statistics of 'namespaces' to 'receiver' at once
+         * and queues the rest. Namespaces still queued for 'receiver' by
+         * previous call are replaced.
+         */
+        void load(QObject *sender, QObject *receiver, const std::vector<std::string> &namespaces);
+
+        /**
+         * @brief Drops cached statistics of collection, e.g. after it is renamed or dropped
+         */
+        void invalidate(const std::string &ns);
+
+        /**
+         * @brief Clears the queue and stops sending results, when connection
+         * is closing. Statistics that are being fetched now are not sent.
+         */
+        void cancel();
+
+        /**
+         * @brief Stops loading for 'receiver', e.g. when it is deleted. Its queued
+         * namespaces are dropped, statistics that are being fetched for it now are
+         * not sent.
+         */
+        void cancel(QObject *receiver);
+
+    private:
+        class Fetcher;
+
+        struct Job
+        {
+            QObject *sender;
+            QObject *receiver;
+            std::string ns;
+        };
+
+        struct CachedStats
+        {
+            MongoCollectionInfo info;
+            qint64 loadedMs;
+        };
+
+        /**
+         * @brief Body of fetching thread 'index', returns when the queue is empty
+         */
+        void fetch(int index);
+
+        /**
+         * @brief Starts fetching threads for queued namespaces. Lock should be held.
+         */
+        void startFetchers();
+        void send(QObject *receiver, Event *event);
+
+        QMutex _lock;
+        std::deque<Job> _queue;
+        std::map<std::string, CachedStats> _cache;
+        std::vector<Fetcher *> _fetchers;
+        std::vector<bool> _isFetching;  // fetcher has not left fetch() yet
+        std::vector<QObject *> _fetchingReceivers; // receiver of job of fetcher, NULL if cancelled
+        bool _isCancelled;
+
+        ConnectionSettings *const _connection;
+        const int _mongoTimeoutSec;
+    };
+}
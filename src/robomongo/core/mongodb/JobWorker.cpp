@@ -0,0 +1,142 @@
+#include "robomongo/core/mongodb/JobWorker.h"
+
+#include <QThread>
+
+#include "robomongo/core/EventBus.h"
+#include "robomongo/core/AppRegistry.h"
+#include "robomongo/core/mongodb/MongoClient.h"
+#include "robomongo/core/mongodb/MongoConnectionPool.h"
+#include "robomongo/core/mongodb/MongoWorker.h"
+#include "robomongo/core/settings/ConnectionSettings.h"
+#include "robomongo/core/utils/Logger.h"
+#include "robomongo/core/utils/QtUtils.h"
+
+namespace
+{
+    /**
+     * @brief Sends progress of copying to the receiver of the job,
+     * not more often than every progressIntervalMs.
+     */
+    class CopyProgressReporter : public Robomongo::CopyProgressHandler
+    {
+    public:
+        enum { progressIntervalMs = 500 };
+
+        CopyProgressReporter(QObject *sender, QObject *receiver, const QAtomicInteger<int> &isQuiting) :
+            _sender(sender),
+            _receiver(receiver),
+            _isQuiting(isQuiting),
+            _lastReportMs(0) {}
+
+        virtual void progress(const Robomongo::MongoNamespace &to, long long documents, long long bytes, qint64 elapsedMs)
+        {
+            if (elapsedMs - _lastReportMs < progressIntervalMs)
+                return;
+
+            _lastReportMs = elapsedMs;
+            double seconds = elapsedMs / 1000.0;
+            double documentsPerSec = seconds > 0 ? documents / seconds : 0;
+            double megabytesPerSec = seconds > 0 ? bytes / (1024.0 * 1024.0) / seconds : 0;
+            Robomongo::AppRegistry::instance().bus()->send(_receiver,
+                new Robomongo::CopyCollectionProgressEvent(_sender, to, documents, bytes, documentsPerSec, megabytesPerSec));
+        }
+
+        virtual bool isCancelled() const
+        {
+            return _isQuiting;
+        }
+
+    private:
+        QObject *const _sender;
+        QObject *const _receiver;
+        const QAtomicInteger<int> &_isQuiting;
+        qint64 _lastReportMs;
+    };
+}
+
+namespace Robomongo
+{
+    JobWorker::JobWorker(ConnectionSettings *connection, int mongoTimeoutSec) : QObject(),
+        _connection(connection),
+        _mongoTimeoutSec(mongoTimeoutSec),
+        _isQuiting(0)
+    {
+        _thread = new QThread();
+        moveToThread(_thread);
+        VERIFY(connect( _thread, SIGNAL(finished()), _thread, SLOT(deleteLater()) ));
+        VERIFY(connect( _thread, SIGNAL(finished()), this, SLOT(deleteLater()) ));
+        _thread->start();
+    }
+
+    JobWorker::~JobWorker()
+    {
+        delete _connection;
+
+        // QThread "_thread" and JobWorker itself will be deleted later
+        // (see JobWorker() constructor)
+    }
+
+    void JobWorker::stop()
+    {
+        // Copying is cancelled by CopyProgressReporter
+        _isQuiting = 1;
+    }
+
+    void JobWorker::stopAndDelete()
+    {
+        _isQuiting = 1;
+        _thread->quit();
+    }
+
+    void JobWorker::handle(DuplicateCollectionRequest *event)
+    {
+        try {
+            // Documents are read with second connection, while the first one inserts them
+            boost::scoped_ptr<MongoClient> client(getClient());
+            boost::scoped_ptr<MongoClient> source(getClient());
+            CopyProgressReporter reporter(this, event->sender(), _isQuiting);
+            client->duplicateCollection(source->connection(), event->ns(), event->newCollection(), &reporter);
+            client->done();
+
+            reply(event->sender(), new DuplicateCollectionResponse(this));
+        } catch(const mongo::DBException &ex) {
+            reply(event->sender(), new DuplicateCollectionResponse(this, EventError(ex.what())));
+            LOG_MSG(ex.what(), mongo::logger::LogSeverity::Error());
+        }
+    }
+
+    void JobWorker::handle(CopyCollectionToDiffServerRequest *event)
+    {
+        try {
+            boost::scoped_ptr<MongoClient> client(getClient());
+            MongoConnectionPool *pool = AppRegistry::instance().connectionPool();
+            ConnectionSettings *sourceSettings = event->sourceSettings();
+            boost::scoped_ptr<MongoClient> source(new MongoClient(pool->acquire(sourceSettings, _mongoTimeoutSec), pool));
+            CopyProgressReporter reporter(this, event->sender(), _isQuiting);
+            client->copyCollectionToDiffServer(source->connection(), sourceSettings->hasEnabledPrimaryCredential(),
+                                               event->from(), event->to(), &reporter);
+            client->done();
+
+            reply(event->sender(), new CopyCollectionToDiffServerResponse(this));
+        } catch(const mongo::DBException &ex) {
+            reply(event->sender(), new CopyCollectionToDiffServerResponse(this, EventError(ex.what())));
+            LOG_MSG(ex.what(), mongo::logger::LogSeverity::Error());
+        }
+    }
+
+    MongoClient *JobWorker::getClient()
+    {
+        MongoConnectionPool *pool = AppRegistry::instance().connectionPool();
+        MongoClient *client = new MongoClient(pool->acquire(_connection, _mongoTimeoutSec), pool);
+        client->setWriteConcern(_connection->writeConcern());
+        return client;
+    }
+
+    void JobWorker::reply(QObject *receiver, Event *event)
+    {
+        if (_isQuiting)
+            return;
+
+        AppRegistry::instance().bus()->send(receiver, event);
+    }
+}
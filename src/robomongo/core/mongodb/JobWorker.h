@@ -0,0 +1,56 @@
+#pragma once
+
+#include <QObject>
+
+#include "robomongo/core/events/MongoEvents.h"
+
+QT_BEGIN_NAMESPACE
+class QThread;
+QT_END_NAMESPACE
+
+namespace Robomongo
+{
+    class MongoClient;
+    class ConnectionSettings;
+
+    /**
+     * @brief Long-running lane of a connection: copying of collections and
+     *        other bulk jobs. Jobs may take minutes, so JobWorker has its own
+     *        dedicated thread and does not hold threads of WorkerThreadPool.
+     *        Jobs of one connection are executed one by one. JobWorker is
+     *        created by MongoWorker on the first job.
+     */
+    class JobWorker : public QObject
+    {
+        Q_OBJECT
+
+    public:
+        /**
+         * @param connection: JobWorker takes ownership of this settings.
+         */
+        JobWorker(ConnectionSettings *connection, int mongoTimeoutSec);
+        ~JobWorker();
+        /**
+         * @brief Stops replying to senders of requests, may be called from any thread
+         */
+        void stop();
+        void stopAndDelete();
+
+    protected Q_SLOTS: // handlers:
+        void handle(DuplicateCollectionRequest *event);
+        void handle(CopyCollectionToDiffServerRequest *event);
+
+    private:
+        MongoClient *getClient();
+
+        /**
+         * @brief Send reply event to object 'receiver'
+         */
+        void reply(QObject *receiver, Event *event);
+
+        QThread *_thread;
+        ConnectionSettings *_connection;
+        const int _mongoTimeoutSec;
+        QAtomicInteger<int> _isQuiting;
+    };
+}
@@ -1,8 +1,17 @@
 #include "robomongo/core/mongodb/MongoClient.h"
 
+#include <deque>
+#include <sstream>
+#include <set>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+
 #include "mongo/db/namespace_string.h"
 
 #include "robomongo/core/domain/MongoDocument.h"
+#include "robomongo/core/mongodb/MongoConnectionPool.h"
 #include "robomongo/core/utils/BsonUtils.h"
 #include "robomongo/shell/bson/json.h"
 
@@ -32,12 +41,193 @@ namespace
         }
         return info;
     }
+
+    // Error of aggregate on servers, that do not know $out stage (MongoDB < 2.6)
+    const int unrecognizedPipelineStageCode = 16436;
+
+    /**
+     * @brief Checks that failed command is not supported by server.
+     * MongoDB 2.4 returns "no such cmd" without error code.
+     */
+    bool isCommandNotFound(const mongo::BSONObj &result)
+    {
+        return result.getIntField("code") == mongo::ErrorCodes::CommandNotFound
+            || std::string(result.getStringField("errmsg")).find("no such") == 0;
+    }
+
+    /**
+     * @brief Turns off socket timeout of connection while this object is alive.
+     * Server-side copy may run longer than timeout of pooled connections,
+     * and the client should not give up while server is still copying.
+     */
+    class SocketTimeoutDisabler
+    {
+    public:
+        explicit SocketTimeoutDisabler(mongo::DBClientBase *connection) :
+            _connection(dynamic_cast<mongo::DBClientConnection *>(connection)),
+            _timeout(_connection ? _connection->getSoTimeout() : 0)
+        {
+            if (_connection)
+                _connection->setSoTimeout(0);
+        }
+
+        ~SocketTimeoutDisabler()
+        {
+            if (_connection)
+                _connection->setSoTimeout(_timeout);
+        }
+
+    private:
+        mongo::DBClientConnection *_connection;
+        double _timeout;
+    };
+
+    // Addresses of servers, that do not support write commands (MongoDB < 2.6).
+    // Writes to them are sent as legacy operations without trying commands first.
+    std::set<std::string> legacyWriteServers;
+    QMutex legacyWriteServersLock;
+
+    /**
+     * @brief Reads documents from cursor in separate thread and groups them
+     * into batches. Not more than 'maxBatches' batches are waiting for
+     * insertion, so reading does not run far ahead of writing.
+     */
+    class CollectionReader : public QThread
+    {
+    public:
+        struct Batch
+        {
+            Batch() : bytes(0) {}
+            std::vector<mongo::BSONObj> documents;
+            long long bytes;
+        };
+
+        CollectionReader(mongo::DBClientCursor *cursor, int maxBatchDocuments, int maxBatchBytes, int maxBatches) :
+            _cursor(cursor),
+            _maxBatchDocuments(maxBatchDocuments),
+            _maxBatchBytes(maxBatchBytes),
+            _maxBatches(maxBatches),
+            _finished(false),
+            _cancelled(false) {}
+
+        /**
+         * @brief Waits for the next batch. Returns false when all documents are read.
+         */
+        bool pop(Batch &batch)
+        {
+            QMutexLocker lock(&_mutex);
+            while (_batches.empty() && !_finished)
+                _notEmpty.wait(&_mutex);
+
+            if (_batches.empty())
+                return false;
+
+            batch = _batches.front();
+            _batches.pop_front();
+            _notFull.wakeAll();
+            return true;
+        }
+
+        /**
+         * @brief Stops reading and waits for the thread
+         */
+        void cancel()
+        {
+            {
+                QMutexLocker lock(&_mutex);
+                _cancelled = true;
+                _notFull.wakeAll();
+            }
+            wait();
+        }
+
+        /**
+         * @brief Error of reading, empty if there was no error
+         */
+        std::string error() const
+        {
+            QMutexLocker lock(&_mutex);
+            return _error;
+        }
+
+    protected:
+        virtual void run()
+        {
+            try {
+                Batch batch;
+                while (_cursor->more()) {
+                    // Documents point into cursor buffer, which is reused for the next reply
+                    mongo::BSONObj obj = _cursor->next().getOwned();
+
+                    if (!batch.documents.empty() &&
+                        (batch.bytes + obj.objsize() > _maxBatchBytes || static_cast<int>(batch.documents.size()) >= _maxBatchDocuments)) {
+                        if (!push(batch))
+                            return;
+                        batch = Batch();
+                    }
+
+                    batch.documents.push_back(obj);
+                    batch.bytes += obj.objsize();
+                }
+
+                if (!batch.documents.empty())
+                    push(batch);
+            } catch(const std::exception &ex) {
+                QMutexLocker lock(&_mutex);
+                _error = ex.what();
+            }
+
+            QMutexLocker lock(&_mutex);
+            _finished = true;
+            _notEmpty.wakeAll();
+        }
+
+    private:
+        bool push(const Batch &batch)
+        {
+            QMutexLocker lock(&_mutex);
+            while (static_cast<int>(_batches.size()) >= _maxBatches && !_cancelled)
+                _notFull.wait(&_mutex);
+
+            if (_cancelled)
+                return false;
+
+            _batches.push_back(batch);
+            _notEmpty.wakeAll();
+            return true;
+        }
+
+        mongo::DBClientCursor *const _cursor;
+        const int _maxBatchDocuments;
+        const int _maxBatchBytes;
+        const int _maxBatches;
+
+        mutable QMutex _mutex;
+        QWaitCondition _notEmpty;
+        QWaitCondition _notFull;
+        std::deque<Batch> _batches;
+        bool _finished;
+        bool _cancelled;
+        std::string _error;
+    };
 }
 
 namespace Robomongo
 {
-    MongoClient::MongoClient(mongo::DBClientBase *const dbclient) :
-        _dbclient(dbclient) { }
+    MongoClient::MongoClient(mongo::DBClientBase *const dbclient, MongoConnectionPool *pool) :
+        _dbclient(dbclient),
+        _pool(pool) { }
+
+    void MongoClient::setWriteConcern(const mongo::BSONObj &writeConcern)
+    {
+        _writeConcern = writeConcern.getOwned();
+    }
+
+    MongoClient::~MongoClient()
+    {
+        if (_pool)
+            _pool->release(_dbclient);
+    }
 
     std::vector<std::string> MongoClient::getCollectionNames(const std::string &dbname) const
     {
@@ -172,6 +362,40 @@ namespace Robomongo
         return result;
     }
 
+    bool MongoClient::isUniqueIndexKey(const MongoNamespace &ns, const std::string &fieldName) const
+    {
+        // "_id" index is always unique, but it is not marked with "unique" flag
+        if (fieldName == "_id")
+            return true;
+
+        std::list<mongo::BSONObj> indexes = _dbclient->getIndexSpecs(ns.toString());
+        for (std::list<mongo::BSONObj>::iterator it = indexes.begin(); it != indexes.end(); ++it) {
+            mongo::BSONObj key = it->getObjectField("key");
+            if (key.nFields() == 1 && fieldName == key.firstElementFieldName() && it->getBoolField("unique"))
+                return true;
+        }
+
+        return false;
+    }
+
+    bool MongoClient::hasSingleKeyType(const MongoNamespace &ns, const std::string &fieldName, int &canonicalType) const
+    {
+        // Documents are sorted by type of key first, so if the first and the last
+        // keys have the same type, keys of all documents between them have it too
+        mongo::BSONObj fields = BSON(fieldName << 1);
+        mongo::BSONObj first = _dbclient->findOne(ns.toString(), mongo::Query().sort(fieldName, 1), &fields);
+        mongo::BSONObj last = _dbclient->findOne(ns.toString(), mongo::Query().sort(fieldName, -1), &fields);
+
+        // Missing keys are sorted as null, arrays are sorted by their elements
+        mongo::BSONElement firstKey = first.getFieldDotted(fieldName);
+        mongo::BSONElement lastKey = last.getFieldDotted(fieldName);
+        if (firstKey.eoo() || lastKey.eoo() || firstKey.type() == mongo::Array || lastKey.type() == mongo::Array)
+            return false;
+
+        canonicalType = firstKey.canonicalType();
+        return canonicalType == lastKey.canonicalType();
+    }
+
     void MongoClient::ensureIndex(const EnsureIndexInfo &oldInfo, const EnsureIndexInfo &newInfo) const
     {   
         std::string ns = newInfo._collection.ns().toString();
@@ -407,40 +631,199 @@ namespace Robomongo
         _dbclient->runCommand("admin", command.obj(), result); // this command should be run against "admin" db
     }
 
-    void MongoClient::duplicateCollection(const MongoNamespace &ns, const std::string &newCollectionName)
+    void MongoClient::duplicateCollection(mongo::DBClientBase *const source, const MongoNamespace &ns, const std::string &newCollectionName,
+                                          CopyProgressHandler *handler /* = NULL */)
     {
-        MongoNamespace from(ns);
         MongoNamespace to(ns.databaseName(), newCollectionName);
 
-        if (!_dbclient->exists(to.toString()))
-            _dbclient->createCollection(to.toString());
+        // Server copies documents itself, they are not transferred through the client
+        if (!_dbclient->exists(to.toString()) && aggregateToCollection(ns, to)) {
+            copyIndexes(_dbclient, ns, to);
+            return;
+        }
 
-        std::unique_ptr<mongo::DBClientCursor> cursor(_dbclient->query(from.toString(), mongo::Query()));
+        copyCollection(source, ns, to, handler);
+    }
 
-        // Cursor may be NULL, it means we have connectivity problem
-        if (!cursor)
-            throw mongo::DBException("Network error while attempting to run query", 0);
+    void MongoClient::copyCollectionToDiffServer(mongo::DBClientBase *const source, bool isSourceAuthenticated,
+                                                 const MongoNamespace &from, const MongoNamespace &to,
+                                                 CopyProgressHandler *handler /* = NULL */)
+    {
+        // Target server pulls documents and indexes directly from source server
+        if (!_dbclient->exists(to.toString()) && cloneCollectionFrom(source->getServerAddress(), isSourceAuthenticated, from, to))
+            return;
 
-        while (cursor->more()) {
-            mongo::BSONObj bsonObj = cursor->next();
-            _dbclient->insert(to.toString(), bsonObj);
+        copyCollection(source, from, to, handler);
+    }
+
+    bool MongoClient::aggregateToCollection(const MongoNamespace &from, const MongoNamespace &to)
+    {
+        // Building { aggregate: <collection>, pipeline: [ { $out: <new collection> } ], cursor: {} }
+        mongo::BSONObjBuilder command;
+        command.append("aggregate", from.collectionName());
+        command.append("pipeline", BSON_ARRAY(BSON("$out" << to.collectionName())));
+        command.append("cursor", mongo::BSONObj());
+
+        // $out is supported since MongoDB 2.6, older servers return an error.
+        // $out writes into temporary collection, so nothing is left on failure.
+        // Other errors (including network ones) are thrown: server may still be copying.
+        mongo::BSONObj result;
+        SocketTimeoutDisabler noTimeout(_dbclient);
+        if (_dbclient->runCommand(from.databaseName(), command.obj(), result))
+            return true;
+
+        if (isCommandNotFound(result) || result.getIntField("code") == unrecognizedPipelineStageCode)
+            return false;
+
+        throw mongo::DBException(std::string("Failed to copy collection: ") + result.getStringField("errmsg"), result.getIntField("code"));
+    }
+
+    bool MongoClient::cloneCollectionFrom(const std::string &sourceAddress, bool isSourceAuthenticated, const MongoNamespace &from, const MongoNamespace &to)
+    {
+        // cloneCollection keeps namespace, and cannot authenticate on source server
+        if (from.toString() != to.toString() || isSourceAuthenticated)
+            return false;
+
+        // Loopback address of the source means another server for the target one
+        if (sourceAddress.find("localhost") == 0 || sourceAddress.find("127.") == 0 || sourceAddress.find("::1") == 0)
+            return false;
+
+        // Building { cloneCollection: <namespace>, from: <host:port> }
+        mongo::BSONObjBuilder command;
+        command.append("cloneCollection", from.toString());
+        command.append("from", sourceAddress);
+
+        // Network errors are thrown, collection is not dropped then: server may still be cloning it
+        mongo::BSONObj result;
+        SocketTimeoutDisabler noTimeout(_dbclient);
+        if (_dbclient->runCommand(to.databaseName(), command.obj(), result))
+            return true;
+
+        if (isCommandNotFound(result))
+            return false;
+
+        // Server reported that cloning failed, partially cloned collection is removed
+        if (_dbclient->exists(to.toString()))
+            _dbclient->dropCollection(to.toString());
+
+        throw mongo::DBException(std::string("Failed to clone collection: ") + result.getStringField("errmsg"), result.getIntField("code"));
+    }
+
+    void MongoClient::copyIndexes(mongo::DBClientBase *const source, const MongoNamespace &from, const MongoNamespace &to)
+    {
+        std::list<mongo::BSONObj> indexes = source->getIndexSpecs(from.toString());
+
+        mongo::BSONArrayBuilder specs;
+        int count = 0;
+        for (std::list<mongo::BSONObj>::const_iterator it = indexes.begin(); it != indexes.end(); ++it) {
+            const mongo::BSONObj &index = *it;
+
+            // _id index is created with collection
+            if (index.getStringField("name") == std::string("_id_"))
+                continue;
+
+            // Namespace of the index is set by server
+            specs.append(index.removeField("ns"));
+            ++count;
         }
+
+        if (count == 0)
+            return;
+
+        // Building { createIndexes: <collection>, indexes: [ <spec>, ... ] }
+        mongo::BSONObjBuilder command;
+        command.append("createIndexes", to.collectionName());
+        command.append("indexes", specs.arr());
+
+        mongo::BSONObj result;
+        if (!_dbclient->runCommand(to.databaseName(), command.obj(), result))
+            throw mongo::DBException(std::string("Failed to create indexes: ") + result.getStringField("errmsg"), mongo::ErrorCodes::InternalError);
     }
 
-    void MongoClient::copyCollectionToDiffServer(mongo::DBClientBase *const fromServ, const MongoNamespace &from, const MongoNamespace &to)
+    void MongoClient::copyCollection(mongo::DBClientBase *const source, const MongoNamespace &from, const MongoNamespace &to,
+                                     CopyProgressHandler *handler /* = NULL */)
     {
-        if (!_dbclient->exists(to.toString()))
+        bool created = !_dbclient->exists(to.toString());
+        if (created)
             _dbclient->createCollection(to.toString());
 
-        std::unique_ptr<mongo::DBClientCursor> cursor(fromServ->query(from.toString(), mongo::Query()));
+        std::unique_ptr<mongo::DBClientCursor> cursor(source->query(from.toString(), mongo::Query()));
 
         // Cursor may be NULL, it means we have connectivity problem
         if (!cursor)
             throw mongo::DBException("Network error while attempting to run query", 0);
 
-        while (cursor->more()) {
-            mongo::BSONObj bsonObj = cursor->next();
-            _dbclient->insert(to.toString(), bsonObj);
+        // Next batches are read while current one is inserted
+        CollectionReader reader(cursor.get(), copyBatchMaxDocuments, mongo::BSONObjMaxUserSize, copyQueueMaxBatches);
+        reader.start();
+
+        QElapsedTimer timer;
+        timer.start();
+        long long documents = 0;
+        long long bytes = 0;
+        bool writeCommands = true;
+
+        // Documents that were not inserted (e.g. _id exists in target collection)
+        // are skipped, copy continues and they are reported at the end
+        long long skippedCount = 0;
+        std::string firstSkipError;
+
+        try {
+            CollectionReader::Batch batch;
+            while (reader.pop(batch)) {
+                if (handler && handler->isCancelled())
+                    break;
+
+                int inserted = 0;
+                std::vector<DocumentWriteError> errors;
+                if (writeCommands)
+                    writeCommands = insertBatch(to, batch.documents, 0, batch.documents.size(), false, inserted, errors);
+
+                if (!writeCommands) {
+                    // Legacy insert reports only the last error of batch
+                    _dbclient->insert(to.toString(), batch.documents, mongo::InsertOption_ContinueOnError);
+                    std::string error = getLastError(to.databaseName());
+                    if (!error.empty())
+                        errors.push_back(DocumentWriteError(-1, error));
+                }
+
+                if (!errors.empty() && firstSkipError.empty()) {
+                    std::stringstream error;
+                    if (errors.front()._index >= 0)
+                        error << "Document #" << (documents + errors.front()._index + 1) << ": ";
+                    error << errors.front()._message;
+                    firstSkipError = error.str();
+                }
+                skippedCount += errors.size();
+
+                // Write concern error is not a problem of single documents
+                throwWriteErrors(std::vector<DocumentWriteError>());
+
+                documents += batch.documents.size();
+                bytes += batch.bytes;
+                if (handler)
+                    handler->progress(to, documents, bytes, timer.elapsed());
+            }
+        } catch(...) {
+            reader.cancel();
+            throw;
+        }
+
+        reader.cancel();
+
+        const std::string error = reader.error();
+        if (!error.empty())
+            throw mongo::DBException(error, mongo::ErrorCodes::InternalError);
+
+        // Indexes of existing collection are left as they are
+        if (created && !(handler && handler->isCancelled()))
+            copyIndexes(source, from, to);
+
+        if (skippedCount > 0) {
+            std::stringstream error;
+            error << "Collection is copied, but " << skippedCount << " document(s) could not be inserted. "
+                  << "First error: " << firstSkipError;
+            throw mongo::DBException(error.str(), mongo::ErrorCodes::InternalError);
         }
     }
 
@@ -451,86 +834,336 @@ namespace Robomongo
 
     void MongoClient::insertDocument(const mongo::BSONObj &obj, const MongoNamespace &ns)
     {
+        int inserted = 0;
+        std::vector<DocumentWriteError> errors;
+        if (insertBatch(ns, std::vector<mongo::BSONObj>(1, obj), 0, 1, true, inserted, errors)) {
+            throwWriteErrors(errors);
+            return;
+        }
+
         _dbclient->insert(ns.toString(), obj);
         checkLastErrorAndThrow(ns.databaseName());
     }
 
+    int MongoClient::insertDocuments(const MongoNamespace &ns, const std::vector<mongo::BSONObj> &objs, bool ordered,
+                                     std::vector<DocumentWriteError> &errors)
+    {
+        int inserted = 0;
+        bool writeCommands = true;
+
+        size_t begin = 0;
+        while (begin < objs.size()) {
+            // Batch is bounded by number of documents and by size of insert command
+            size_t end = begin;
+            int batchSize = 0;
+            while (end < objs.size() && end - begin < writeBatchMaxDocuments) {
+                int size = objs[end].objsize();
+                if (end > begin && batchSize + size > mongo::BSONObjMaxUserSize)
+                    break;
+
+                batchSize += size;
+                ++end;
+            }
+
+            size_t errorsBefore = errors.size();
+            if (writeCommands)
+                writeCommands = insertBatch(ns, objs, begin, end, ordered, inserted, errors);
+
+            // Legacy inserts, one by one, to know which document failed
+            if (!writeCommands) {
+                for (size_t i = begin; i < end; ++i) {
+                    _dbclient->insert(ns.toString(), objs[i]);
+                    std::string lastError = getLastError(ns.databaseName());
+                    if (lastError.empty()) {
+                        ++inserted;
+                        continue;
+                    }
+
+                    errors.push_back(DocumentWriteError(i, lastError));
+                    if (ordered)
+                        break;
+                }
+            }
+
+            if (ordered && errors.size() > errorsBefore)
+                break;
+
+            begin = end;
+        }
+
+        return inserted;
+    }
+
+    bool MongoClient::insertBatch(const MongoNamespace &ns, const std::vector<mongo::BSONObj> &objs, size_t begin, size_t end,
+                                  bool ordered, int &inserted, std::vector<DocumentWriteError> &errors)
+    {
+        // Building { insert: <collection>, documents: [ <document>, ... ], ordered: <bool> }
+        mongo::BSONObjBuilder command;
+        command.append("insert", ns.collectionName());
+        mongo::BSONArrayBuilder documents(command.subarrayStart("documents"));
+        for (size_t i = begin; i < end; ++i)
+            documents.append(objs[i]);
+        documents.done();
+        command.append("ordered", ordered);
+
+        return runWriteCommand(ns.databaseName(), command, begin, inserted, errors);
+    }
+
+    bool MongoClient::runWriteCommand(const std::string &db, mongo::BSONObjBuilder &command, size_t firstIndex,
+                                      int &affected, std::vector<DocumentWriteError> &errors)
+    {
+        const std::string server = _dbclient->getServerAddress();
+        {
+            QMutexLocker lock(&legacyWriteServersLock);
+            if (legacyWriteServers.count(server))
+                return false;
+        }
+
+        if (!_writeConcern.isEmpty())
+            command.append("writeConcern", _writeConcern);
+
+        mongo::BSONObj result;
+        if (!_dbclient->runCommand(db, command.obj(), result)) {
+            std::string errmsg = result.getStringField("errmsg");
+            if (isCommandNotFound(result)) {
+                QMutexLocker lock(&legacyWriteServersLock);
+                legacyWriteServers.insert(server);
+                return false;
+            }
+
+            throw mongo::DBException(errmsg, result.getIntField("code"));
+        }
+
+        affected += result.getIntField("n");
+
+        // { writeErrors: [ { index: <index in command>, code: <code>, errmsg: <message> }, ... ] }
+        if (result.hasField("writeErrors")) {
+            std::vector<mongo::BSONElement> writeErrors = result.getField("writeErrors").Array();
+            for (std::vector<mongo::BSONElement>::const_iterator it = writeErrors.begin(); it != writeErrors.end(); ++it) {
+                mongo::BSONObj writeError = it->Obj();
+                errors.push_back(DocumentWriteError(firstIndex + writeError.getIntField("index"), writeError.getStringField("errmsg")));
+            }
+        }
+
+        // Documents are written, but write concern is not satisfied (e.g. wtimeout expired).
+        // Error is kept, so that number of written documents is not lost.
+        if (result.hasField("writeConcernError")) {
+            mongo::BSONObj writeConcernError = result.getObjectField("writeConcernError");
+            _writeConcernError = writeConcernError.getStringField("errmsg");
+        }
+
+        return true;
+    }
+
+    void MongoClient::throwWriteErrors(const std::vector<DocumentWriteError> &errors) const
+    {
+        if (!errors.empty())
+            throw mongo::DBException(errors.front()._message, mongo::ErrorCodes::InternalError);
+
+        if (!_writeConcernError.empty())
+            throw mongo::DBException(_writeConcernError, mongo::ErrorCodes::InternalError);
+    }
+
+    std::string MongoClient::getLastError(const std::string &db)
+    {
+        // Building { getLastError: 1, w: <w>, j: <j>, wtimeout: <ms> }
+        mongo::BSONObjBuilder command;
+        command.append("getLastError", 1);
+        command.appendElements(_writeConcern);
+
+        mongo::BSONObj result;
+        _dbclient->runCommand(db, command.obj(), result);
+        return _dbclient->getLastErrorString(result);
+    }
+
     void MongoClient::saveDocument(const mongo::BSONObj &obj, const MongoNamespace &ns)
     {
         mongo::BSONElement id = obj.getField("_id");
         mongo::BSONObjBuilder builder;
         builder.append(id);
         mongo::BSONObj bsonQuery = builder.obj();
-        mongo::Query query(bsonQuery);
 
-        _dbclient->update(ns.toString(), query, obj, true, false);
+        // Building { update: <collection>, updates: [ { q: { _id: <id> }, u: <document>, upsert: true } ] }
+        mongo::BSONObjBuilder command;
+        command.append("update", ns.collectionName());
+        mongo::BSONArrayBuilder updates(command.subarrayStart("updates"));
+        updates.append(BSON("q" << bsonQuery << "u" << obj << "upsert" << true << "multi" << false));
+        updates.done();
+
+        int updated = 0;
+        std::vector<DocumentWriteError> errors;
+        if (runWriteCommand(ns.databaseName(), command, 0, updated, errors)) {
+            throwWriteErrors(errors);
+            return;
+        }
+
+        _dbclient->update(ns.toString(), mongo::Query(bsonQuery), obj, true, false);
         checkLastErrorAndThrow(ns.databaseName());
     }
 
     void MongoClient::removeDocuments(const MongoNamespace &ns, mongo::Query query, bool justOne /*= true*/)
     {
+        // Building { delete: <collection>, deletes: [ { q: <query>, limit: <0 or 1> } ] }
+        mongo::BSONObjBuilder command;
+        command.append("delete", ns.collectionName());
+        mongo::BSONArrayBuilder deletes(command.subarrayStart("deletes"));
+        deletes.append(BSON("q" << query.getFilter() << "limit" << (justOne ? 1 : 0)));
+        deletes.done();
+
+        int removed = 0;
+        std::vector<DocumentWriteError> errors;
+        if (runWriteCommand(ns.databaseName(), command, 0, removed, errors)) {
+            throwWriteErrors(errors);
+            return;
+        }
+
         _dbclient->remove(ns.toString(), query, justOne);
         checkLastErrorAndThrow(ns.databaseName());
     }
 
-    std::vector<MongoDocumentPtr> MongoClient::query(const MongoQueryInfo &info)
+    void MongoClient::removeDocumentsById(const MongoNamespace &ns, const std::vector<mongo::BSONObj> &ids)
     {
-        MongoNamespace ns(info._info._ns);
+        // Space for { _id: { $in: [] } } and array indexes
+        const int maxQuerySize = mongo::BSONObjMaxUserSize - 1024;
+        const int elementOverhead = 16;
+
+        std::vector<mongo::BSONObj>::const_iterator it = ids.begin();
+        while (it != ids.end()) {
+            mongo::BSONArrayBuilder in;
+            int querySize = 0;
+            for (; it != ids.end(); ++it) {
+                mongo::BSONElement id = it->getField("_id");
+                if (id.eoo())
+                    continue;
+
+                int size = id.size() + elementOverhead;
+                if (querySize > 0 && querySize + size > maxQuerySize)
+                    break;
+
+                in.append(id);
+                querySize += size;
+            }
 
-        //int limit = (info.limit <= 0) ? 50 : info.limit;
+            if (querySize == 0)
+                continue;
+
+            // Building { _id: { $in: [ <id>, ... ] } }
+            mongo::BSONObj query = BSON("_id" << BSON("$in" << in.arr()));
+            removeDocuments(ns, mongo::Query(query), false);
+        }
+    }
 
+    std::vector<MongoDocumentPtr> MongoClient::query(const MongoQueryInfo &info)
+    {
         std::vector<MongoDocumentPtr> docs;
 
-        if (info._limit == -1) // it means that we do not need to load any documents
+        std::unique_ptr<mongo::DBClientCursor> cursor = openCursor(info);
+        if (!cursor) // it means that we do not need to load any documents
             return docs;
 
+        while (cursor->more()) {
+            std::vector<MongoDocumentPtr> batch = nextBatch(cursor.get());
+            docs.insert(docs.end(), batch.begin(), batch.end());
+        }
+
+        return docs;
+    }
+
+    std::unique_ptr<mongo::DBClientCursor> MongoClient::openCursor(const MongoQueryInfo &info, bool isKeysetAllowed /* = false */)
+    {
+        if (info._limit == -1) // it means that we do not need to load any documents
+            return std::unique_ptr<mongo::DBClientCursor>();
+
+        MongoNamespace ns(info._info._ns);
+
+        mongo::Query query = info._query;
+        int skip = info._skip;
+
+        // Range query costs the same for any page, while skip walks all previous documents
+        mongo::BSONObj keysetQuery = isKeysetAllowed ? makeKeysetQuery(info) : mongo::BSONObj();
+        if (!keysetQuery.isEmpty()) {
+            query = keysetQuery;
+            skip = 0;
+        }
+
         std::unique_ptr<mongo::DBClientCursor> cursor = _dbclient->query(
-            ns.toString(), info._query, info._limit, info._skip,
+            ns.toString(), query, info._limit, skip,
             info._fields.nFields() ? &info._fields : 0, info._options, info._batchSize);
 
         // DBClientBase::query may return nullptr
         if (!cursor)
             throw mongo::DBException("Network error while attempting to run query", 0);
 
-        while (cursor->more()) {
+        return cursor;
+    }
+
+    mongo::BSONObj MongoClient::makeKeysetQuery(const MongoQueryInfo &info) const
+    {
+        mongo::BSONElement boundary = info._boundary.firstElement();
+        if (boundary.eoo())
+            return mongo::BSONObj();
+
+        // Only sort by one field with unique index gives strict order of documents
+        mongo::BSONObj sortOrder = info.sortOrder();
+        if (sortOrder.nFields() != 1)
+            return mongo::BSONObj();
+
+        mongo::BSONElement sortField = sortOrder.firstElement();
+        std::string fieldName = sortField.fieldName();
+        if (fieldName != boundary.fieldName() || !sortField.isNumber())
+            return mongo::BSONObj();
+
+        mongo::BSONObjBuilder range;
+        range.appendAs(boundary, sortField.number() < 0 ? "$lt" : "$gt");
+
+        mongo::BSONObj condition = BSON(fieldName << range.obj());
+        mongo::BSONObj filter = info.filter();
+        if (!filter.isEmpty())
+            condition = BSON("$and" << BSON_ARRAY(filter << condition));
+
+        // Keep all special fields (orderby, hint, etc.) of the original query
+        mongo::BSONObjBuilder builder;
+        builder.append("query", condition);
+        mongo::BSONObjIterator it(info._query);
+        while (it.more()) {
+            mongo::BSONElement element = it.next();
+            if (mongo::StringData(element.fieldName()) != "query")
+                builder.append(element);
+        }
+        return builder.obj();
+    }
+
+    std::vector<MongoDocumentPtr> MongoClient::nextBatch(mongo::DBClientCursor *cursor, int maxCount /* = 0 */)
+    {
+        std::vector<MongoDocumentPtr> docs;
+
+        // more() issues getMore when current batch is exhausted,
+        // after that we only drain what is already received
+        if (!cursor->more())
+            return docs;
+
+        do {
             mongo::BSONObj bsonObj = cursor->next();
             MongoDocumentPtr doc(new MongoDocument(bsonObj.getOwned()));
             docs.push_back(doc);
-        }
+        } while (cursor->moreInCurrentBatch() && (maxCount <= 0 || docs.size() < maxCount));
 
         return docs;
     }
 
     MongoCollectionInfo MongoClient::runCollStatsCommand(const std::string &ns)
     {
-        MongoCollectionInfo info(ns);
-        return info;
-
-/*      // Commented for now, to speedup load of collection names
         MongoNamespace mongons(ns);
 
-        mongo::BSONObjBuilder command; // { collStats: "db.collection", scale : 1 }
+        mongo::BSONObjBuilder command; // { collStats: "collection", scale : 1 }
         command.append("collStats", mongons.collectionName());
         command.append("scale", 1);
 
         mongo::BSONObj result;
-        _dbclient->runCommand(mongons.databaseName(), command.obj(), result);
-        std::string isCV = result.toString();
-        MongoCollectionInfo newInfo(result);
-        return newInfo;
-        */
-    }
+        if (!_dbclient->runCommand(mongons.databaseName(), command.obj(), result))
+            throw mongo::DBException(result.getStringField("errmsg"), result.getIntField("code"));
 
-    std::vector<MongoCollectionInfo> MongoClient::runCollStatsCommand(const std::vector<std::string> &namespaces)
-    {
-        std::vector<MongoCollectionInfo> infos;
-        for (std::vector<std::string>::const_iterator it = namespaces.begin(); it != namespaces.end(); ++it) {
-            MongoCollectionInfo info = runCollStatsCommand(*it);
-            if (info.ns().isValid()) {
-                infos.push_back(info);
-            }            
-        }
-        return infos;
+        return MongoCollectionInfo(ns, result);
     }
 
     void MongoClient::done()
@@ -539,9 +1172,15 @@ namespace Robomongo
         //_scopedConnection->done();
     }
 
+    void MongoClient::keepConnection()
+    {
+        if (_pool)
+            _pool->keep(_dbclient);
+    }
+
     void MongoClient::checkLastErrorAndThrow(const std::string &db)
     {
-        std::string lastError = _dbclient->getLastError(db);
+        std::string lastError = getLastError(db);
 
         // Nothing to do when there is no error
         if (lastError.empty())
@@ -11,10 +11,51 @@
 
 namespace Robomongo
 {
+    class MongoConnectionPool;
+
+    /**
+     * @brief Receives progress of collection copying, see MongoClient::copyCollection()
+     */
+    class CopyProgressHandler
+    {
+    public:
+        virtual ~CopyProgressHandler() {}
+
+        /**
+         * @brief Called after every inserted batch
+         */
+        virtual void progress(const MongoNamespace &to, long long documents, long long bytes, qint64 elapsedMs) = 0;
+
+        /**
+         * @brief Copying stops when this returns true
+         */
+        virtual bool isCancelled() const = 0;
+    };
+
     class MongoClient
     {
     public:
-        MongoClient(mongo::DBClientBase *const scopedConnection);
+        /**
+         * @brief If 'pool' is specified, connection is returned to it on destruction
+         */
+        MongoClient(mongo::DBClientBase *const scopedConnection, MongoConnectionPool *pool = NULL);
+        ~MongoClient();
+
+        mongo::DBClientBase *connection() const { return _dbclient; }
+
+        /**
+         * @brief Write concern that is sent with insert, update and delete
+         * commands, see ConnectionSettings::writeConcern(). When empty,
+         * server default is used.
+         */
+        void setWriteConcern(const mongo::BSONObj &writeConcern);
+
+        /**
+         * @brief Error of write concern of write commands, when documents are written,
+         * but write concern is not satisfied. Empty, if there was no such error.
+         * insertDocuments() does not throw it, other writes do.
+         */
+        const std::string &writeConcernError() const { return _writeConcernError; }
 
         std::vector<std::string> getCollectionNames(const std::string &dbname) const;
         std::vector<std::string> getDatabaseNames() const;
@@ -27,6 +68,15 @@ namespace Robomongo
 
         std::vector<MongoFunction> getFunctions(const std::string &dbName);
         std::vector<EnsureIndexInfo> getIndexes(const MongoCollectionInfo &collection) const;
+        bool isUniqueIndexKey(const MongoNamespace &ns, const std::string &fieldName) const;
+
+        /**
+         * @brief Checks that all documents of 'ns' have 'fieldName' of the same
+         * canonical BSON type, by the first and the last key in sort order.
+         * Both keys are read by index, if field is indexed.
+         * @param canonicalType: type of keys, if true is returned
+         */
+        bool hasSingleKeyType(const MongoNamespace &ns, const std::string &fieldName, int &canonicalType) const;
         void dropIndexFromCollection(const MongoCollectionInfo &collection, const std::string &indexName) const;
         void ensureIndex(const EnsureIndexInfo &oldInfo, const EnsureIndexInfo &newInfo) const;
 
@@ -42,22 +92,149 @@ namespace Robomongo
 
         void createCollection(const std::string &ns, long long size, bool capped, int max, const mongo::BSONObj& extraOptions, mongo::BSONObj* info = nullptr);
         void renameCollection(const MongoNamespace &ns, const std::string &newCollectionName);
-        void duplicateCollection(const MongoNamespace &ns, const std::string &newCollectionName);
+        enum { copyBatchMaxDocuments = 1000, copyQueueMaxBatches = 4 };
+
+        /**
+         * @brief Copies collection within this server. Server copies documents
+         * with aggregation $out when new collection does not exist. Otherwise
+         * documents are read through 'source', which should be another
+         * connection to this server.
+         */
+        void duplicateCollection(mongo::DBClientBase *const source, const MongoNamespace &ns, const std::string &newCollectionName,
+                                 CopyProgressHandler *handler = NULL);
         void dropCollection(const MongoNamespace &ns);
-        void copyCollectionToDiffServer(mongo::DBClientBase *const, const MongoNamespace &from, const MongoNamespace &to);
+
+        /**
+         * @brief Copies collection from 'source' server to this one. If this server
+         * can reach the source, it clones collection itself (cloneCollection),
+         * otherwise documents are copied through the client.
+         * @param isSourceAuthenticated: source requires credentials, that
+         * cloneCollection cannot pass, so documents are copied through the client
+         */
+        void copyCollectionToDiffServer(mongo::DBClientBase *const source, bool isSourceAuthenticated,
+                                        const MongoNamespace &from, const MongoNamespace &to,
+                                        CopyProgressHandler *handler = NULL);
+
+        /**
+         * @brief Reads documents of 'from' through 'source' and inserts them
+         * into 'to' with this connection. Reading is done in separate thread,
+         * documents are inserted in batches of up to copyBatchMaxDocuments
+         * documents and mongo::BSONObjMaxUserSize bytes, while next batches are read.
+         * Indexes are recreated, if target collection is created by this call.
+         * Documents that cannot be inserted (e.g. their _id exists in 'to') are
+         * skipped, DBException with number of them is thrown after the copy.
+         */
+        void copyCollection(mongo::DBClientBase *const source, const MongoNamespace &from, const MongoNamespace &to,
+                            CopyProgressHandler *handler = NULL);
 
         void insertDocument(const mongo::BSONObj &obj, const MongoNamespace &ns);
+
+        enum { writeBatchMaxDocuments = 1000 };
+
+        /**
+         * @brief Inserts documents with insert commands, in batches of up to
+         * writeBatchMaxDocuments documents and mongo::BSONObjMaxUserSize bytes.
+         * If 'ordered', insertion stops at the first failed document.
+         * Errors of documents are added to 'errors'.
+         * @return number of inserted documents
+         */
+        int insertDocuments(const MongoNamespace &ns, const std::vector<mongo::BSONObj> &objs, bool ordered,
+                            std::vector<DocumentWriteError> &errors);
         void saveDocument(const mongo::BSONObj &obj, const MongoNamespace &ns);
         void removeDocuments(const MongoNamespace &ns, mongo::Query query, bool justOne = true);
+
+        /**
+         * @brief Removes documents with { _id: { $in: [...] } } queries.
+         * @param ids: objects with single _id field. Ids are split into
+         * several queries, if they do not fit into one BSON object.
+         */
+        void removeDocumentsById(const MongoNamespace &ns, const std::vector<mongo::BSONObj> &ids);
         std::vector<MongoDocumentPtr> query(const MongoQueryInfo &info);
 
+        /**
+         * @brief Opens server cursor for the query described by 'info'.
+         * Returns NULL when nothing should be loaded (limit is -1).
+         * If 'isKeysetAllowed' and 'info' has page boundary, range query is used
+         * instead of skip. Caller checks that sort key is unique and has the same
+         * type in all documents, see isUniqueIndexKey() and hasSingleKeyType().
+         */
+        std::unique_ptr<mongo::DBClientCursor> openCursor(const MongoQueryInfo &info, bool isKeysetAllowed = false);
+
+        /**
+         * @brief Reads documents that are already received in the current
+         * batch of cursor, requesting next batch from server if needed.
+         * Not more than 'maxCount' documents are read, if it is positive.
+         */
+        std::vector<MongoDocumentPtr> nextBatch(mongo::DBClientCursor *cursor, int maxCount = 0);
+
+        /**
+         * @brief Runs collStats command for collection 'ns' ("db.collection")
+         */
         MongoCollectionInfo runCollStatsCommand(const std::string &ns);
-        std::vector<MongoCollectionInfo> runCollStatsCommand(const std::vector<std::string> &namespaces);
 
         void done();
 
+        /**
+         * @brief Connection of this client is kept with open cursor, so it is
+         * not counted in maximum size of connection pool
+         */
+        void keepConnection();
+
     private:
+        /**
+         * @brief Builds range query, that returns documents after 'info._boundary'.
+         * Returns empty object, when sort order does not allow this.
+         */
+        mongo::BSONObj makeKeysetQuery(const MongoQueryInfo &info) const;
+
+        /**
+         * @brief Inserts documents [begin, end) of 'objs' with one insert command.
+         * Returns false if server does not support write commands (MongoDB < 2.6).
+         */
+        bool insertBatch(const MongoNamespace &ns, const std::vector<mongo::BSONObj> &objs, size_t begin, size_t end,
+                         bool ordered, int &inserted, std::vector<DocumentWriteError> &errors);
+
+        /**
+         * @brief Appends write concern to insert, update or delete 'command' and runs it.
+         * Number of affected documents is added to 'affected', errors of write operations
+         * are added to 'errors' with index of operation shifted by 'firstIndex'.
+         * Error of write concern is kept in writeConcernError().
+         * Returns false if server does not support write commands (MongoDB < 2.6),
+         * this is remembered for the server, so next writes do not try commands.
+         */
+        bool runWriteCommand(const std::string &db, mongo::BSONObjBuilder &command, size_t firstIndex,
+                             int &affected, std::vector<DocumentWriteError> &errors);
+
+        /**
+         * @brief Server-side copy paths. Return false when server does not support
+         * them, then documents should be copied by copyCollection(). Other errors
+         * are thrown. Commands run without socket timeout.
+         */
+        bool aggregateToCollection(const MongoNamespace &from, const MongoNamespace &to);
+        bool cloneCollectionFrom(const std::string &sourceAddress, bool isSourceAuthenticated,
+                                 const MongoNamespace &from, const MongoNamespace &to);
+
+        /**
+         * @brief Creates indexes of 'from' collection on 'to' collection, except _id index
+         */
+        void copyIndexes(mongo::DBClientBase *const source, const MongoNamespace &from, const MongoNamespace &to);
+
+        /**
+         * @brief Throws error of the first document that was not written,
+         * or error of write concern
+         */
+        void throwWriteErrors(const std::vector<DocumentWriteError> &errors) const;
+
+        /**
+         * @brief Runs getLastError with write concern of this client, for legacy writes
+         * @return error message, or empty string
+         */
+        std::string getLastError(const std::string &db);
+
         mongo::DBClientBase *const _dbclient;
+        MongoConnectionPool *const _pool;
+        mongo::BSONObj _writeConcern;
+        std::string _writeConcernError;
         void checkLastErrorAndThrow(const std::string &db);
     };
 }
@@ -0,0 +1,245 @@
+#include "robomongo/core/mongodb/MongoConnectionPool.h"
+
+#include <sstream>
+#include <algorithm>
+#include <QElapsedTimer>
+
+#include <mongo/client/dbclientinterface.h>
+#include <mongo/util/net/ssl_manager.h>
+#include <mongo/util/net/ssl_options.h>
+
+#include "robomongo/core/settings/ConnectionSettings.h"
+#include "robomongo/core/settings/CredentialSettings.h"
+#include "robomongo/core/settings/SslSettings.h"
+
+namespace
+{
+    /**
+     * @brief Update global mongo SSL settings (mongo::sslGlobalParams) according to
+     *        SSL settings of the connection that is going to be opened.
+     */
+    void writeGlobalSSLparams(const Robomongo::SslSettings *const sslSettings)
+    {
+        // Update global mongo SSL settings according to SSL enable/disabled status
+        if (!sslSettings->sslEnabled()) {
+            // Disable forced SSL mode for outgoing connections
+            mongo::sslGlobalParams.sslMode.store(mongo::SSLParams::SSLMode_allowSSL);
+            return;
+        }
+
+        // Force SSL mode for outgoing connections
+        mongo::sslGlobalParams.sslMode.store(mongo::SSLParams::SSLMode_requireSSL);
+        mongo::sslGlobalParams.sslCAFile = sslSettings->caFile();
+        mongo::sslGlobalParams.sslPEMKeyFile = sslSettings->pemKeyFile();
+        mongo::sslGlobalParams.sslPEMKeyPassword =
+            sslSettings->pemKeyEncrypted() ? sslSettings->pemPassPhrase() : "";
+        mongo::sslGlobalParams.sslAllowInvalidCertificates = sslSettings->allowInvalidCertificates();
+        mongo::sslGlobalParams.sslCRLFile = sslSettings->crlFile();
+        mongo::sslGlobalParams.sslAllowInvalidHostnames = sslSettings->allowInvalidHostnames();
+    }
+
+    // SSL parameters are global, so connections are opened one at a time
+    QMutex connectLock;
+}
+
+namespace Robomongo
+{
+    MongoConnectionPool::MongoConnectionPool() { }
+
+    MongoConnectionPool::~MongoConnectionPool()
+    {
+        QMutexLocker lock(&_lock);
+
+        for (std::map<std::string, ConnectionsContainerType>::iterator it = _idle.begin(); it != _idle.end(); ++it) {
+            ConnectionsContainerType &connections = it->second;
+            for (ConnectionsContainerType::iterator conn = connections.begin(); conn != connections.end(); ++conn) {
+                delete *conn;
+            }
+        }
+        _idle.clear();
+    }
+
+    mongo::DBClientBase *MongoConnectionPool::acquire(ConnectionSettings *settings, int timeoutSec, bool mayReturnNull /* = false */)
+    {
+        const std::string key = poolKey(settings);
+        Lease lease = { key, std::max<int>(minPoolSize, settings->maxPoolSize()), false };
+
+        {
+            QMutexLocker lock(&_lock);
+            QElapsedTimer waiting;
+            waiting.start();
+            while (true) {
+                ConnectionsContainerType &connections = _idle[key];
+                while (!connections.empty()) {
+                    mongo::DBClientBase *conn = connections.back();
+                    connections.pop_back();
+
+                    // Idle connection may be dropped by server or network
+                    if (conn->isFailed()) {
+                        delete conn;
+                        closed(key);
+                        continue;
+                    }
+
+                    _borrowed[conn] = lease;
+                    return conn;
+                }
+
+                // Place for new connection is reserved, while it is opened
+                int &opened = _opened[key];
+                if (opened < lease.maxPoolSize) {
+                    opened++;
+                    break;
+                }
+
+                qint64 remainingMs = timeoutSec * 1000LL - waiting.elapsed();
+                if (remainingMs <= 0) {
+                    std::stringstream error;
+                    error << "All " << lease.maxPoolSize << " connections to "
+                          << settings->getFullAddress() << " are in use";
+                    throw mongo::DBException(error.str(), 0);
+                }
+
+                _released.wait(&_lock, remainingMs);
+            }
+        }
+
+        // New connection is opened without holding the pool lock,
+        // because it may take up to connection timeout
+        mongo::DBClientBase *conn = NULL;
+        try {
+            conn = connect(settings, timeoutSec, mayReturnNull);
+        } catch (...) {
+            QMutexLocker lock(&_lock);
+            closed(key);
+            throw;
+        }
+
+        QMutexLocker lock(&_lock);
+        if (!conn) {
+            closed(key);
+            return NULL;
+        }
+
+        _borrowed[conn] = lease;
+        return conn;
+    }
+
+    void MongoConnectionPool::release(mongo::DBClientBase *connection)
+    {
+        if (!connection)
+            return;
+
+        QMutexLocker lock(&_lock);
+
+        std::map<mongo::DBClientBase *, Lease>::iterator it = _borrowed.find(connection);
+        if (it == _borrowed.end()) {
+            delete connection;
+            return;
+        }
+
+        Lease lease = it->second;
+        _borrowed.erase(it);
+
+        ConnectionsContainerType &connections = _idle[lease.key];
+        if (lease.isKept) {
+            // Kept connection takes place in the pool again, if it is free
+            if (connection->isFailed() || _opened[lease.key] >= lease.maxPoolSize) {
+                delete connection;
+                return;
+            }
+            _opened[lease.key]++;
+        }
+
+        if (connection->isFailed() || static_cast<int>(connections.size()) >= lease.maxPoolSize) {
+            delete connection;
+            closed(lease.key);
+            return;
+        }
+
+        connections.push_back(connection);
+        _released.wakeAll();
+    }
+
+    void MongoConnectionPool::keep(mongo::DBClientBase *connection)
+    {
+        QMutexLocker lock(&_lock);
+
+        std::map<mongo::DBClientBase *, Lease>::iterator it = _borrowed.find(connection);
+        if (it == _borrowed.end() || it->second.isKept)
+            return;
+
+        it->second.isKept = true;
+        closed(it->second.key);
+    }
+
+    void MongoConnectionPool::closed(const std::string &key)
+    {
+        _opened[key]--;
+        _released.wakeAll();
+    }
+
+    std::string MongoConnectionPool::poolKey(ConnectionSettings *settings)
+    {
+        std::stringstream key;
+        key << settings->getFullAddress();
+
+        if (settings->hasEnabledPrimaryCredential()) {
+            CredentialSettings *credential = settings->primaryCredential();
+            key << "|" << credential->databaseName()
+                << "|" << credential->userName()
+                << "|" << credential->userPassword()
+                << "|" << credential->mechanism();
+        }
+
+        const SslSettings *const ssl = settings->sslSettings();
+        if (ssl->sslEnabled()) {
+            key << "|ssl|" << ssl->pemKeyFile()
+                << "|" << ssl->caFile()
+                << "|" << ssl->crlFile()
+                << "|" << ssl->allowInvalidHostnames()
+                << "|" << ssl->allowInvalidCertificates();
+        }
+
+        return key.str();
+    }
+
+    mongo::DBClientBase *MongoConnectionPool::connect(ConnectionSettings *settings, int timeoutSec, bool mayReturnNull)
+    {
+        // Timeout for operations
+        // Connect timeout is fixed, but short, at 5 seconds (see headers for DBClientConnection)
+        mongo::DBClientConnection *conn = new mongo::DBClientConnection(true, timeoutSec);
+
+        {
+            QMutexLocker lock(&connectLock);
+            writeGlobalSSLparams(settings->sslSettings());
+
+            mongo::Status status = conn->connect(settings->info());
+            if (!status.isOK() && mayReturnNull) {
+                delete conn;
+                return NULL;
+            }
+        }
+
+        if (settings->hasEnabledPrimaryCredential()) {
+            CredentialSettings *credentials = settings->primaryCredential();
+
+            // Building BSON object:
+            mongo::BSONObj authParams(mongo::BSONObjBuilder()
+                .append("user", credentials->userName())
+                .append("db", credentials->databaseName())
+                .append("pwd", credentials->userPassword())
+                .append("mechanism", credentials->mechanism())
+                .obj());
+
+            try {
+                conn->auth(authParams);
+            } catch (...) {
+                delete conn;
+                throw;
+            }
+        }
+
+        return conn;
+    }
+}
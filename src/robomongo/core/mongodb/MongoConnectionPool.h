@@ -0,0 +1,105 @@
+#pragma once
+
+#include <map>
+#include <vector>
+#include <QMutex>
+#include <QWaitCondition>
+
+namespace mongo
+{
+    class DBClientBase;
+}
+
+namespace Robomongo
+{
+    class ConnectionSettings;
+
+    /**
+     * @brief Pool of connected and authenticated MongoDB connections.
+     *        Connections are grouped by ConnectionSettings (address, credential
+     *        and SSL), so all workers and shells of one server share sockets.
+     *        Connection is borrowed for one request and returned after it.
+     *
+     *        At most ConnectionSettings::maxPoolSize() connections (borrowed and
+     *        idle) are opened for one server. When all of them are borrowed,
+     *        acquire() waits until one is returned. Connections of open paging
+     *        cursors stay borrowed while cursors are kept, they are not counted
+     *        (see keep()), so requests of explorer and shells do not wait for them.
+     *
+     *        You can access this pool via:
+     *        AppRegistry::instance().connectionPool()
+     *
+     * @threadsafe yes
+     */
+    class MongoConnectionPool
+    {
+    public:
+        /**
+         * @brief Copying of collection borrows two connections at once,
+         *        so smaller maximum size of pool is not used
+         */
+        enum { minPoolSize = 2 };
+
+        MongoConnectionPool();
+
+        /**
+         * @brief Closes all idle connections
+         */
+        virtual ~MongoConnectionPool();
+
+        /**
+         * @brief Returns idle connection for 'settings' or opens new one, if
+         *        the pool has less than maximum number of connections. Otherwise
+         *        waits up to 'timeoutSec' until connection is returned.
+         *        Throws mongo::DBException if authentication fails or waiting
+         *        for connection times out.
+         * @param mayReturnNull: return NULL instead of connection that
+         *        failed to connect.
+         */
+        mongo::DBClientBase *acquire(ConnectionSettings *settings, int timeoutSec, bool mayReturnNull = false);
+
+        /**
+         * @brief Returns connection to the pool. Connection is closed when
+         *        it is broken.
+         */
+        void release(mongo::DBClientBase *connection);
+
+        /**
+         * @brief Borrowed connection will be kept for a long time (e.g. by open
+         *        cursor). It is not counted in maximum size of pool from now on.
+         *        When it is released, it is returned to the pool if there is
+         *        place for it, and closed otherwise.
+         */
+        void keep(mongo::DBClientBase *connection);
+
+    protected:
+        /**
+         * @brief Opens and authenticates new connection
+         */
+        virtual mongo::DBClientBase *connect(ConnectionSettings *settings, int timeoutSec, bool mayReturnNull);
+
+    private:
+        typedef std::vector<mongo::DBClientBase *> ConnectionsContainerType;
+
+        struct Lease
+        {
+            std::string key;
+            int maxPoolSize;
+            bool isKept;        // connection is not counted in _opened
+        };
+
+        static std::string poolKey(ConnectionSettings *settings);
+
+        /**
+         * @brief Connection of 'key' is closed or failed to open, should be called under _lock
+         */
+        void closed(const std::string &key);
+
+        std::map<std::string, ConnectionsContainerType> _idle;
+        std::map<mongo::DBClientBase *, Lease> _borrowed;
+        std::map<std::string, int> _opened; // borrowed (except kept), idle and opening connections
+        QMutex _lock;
+        QWaitCondition _released;           // connection of any server is returned or closed
+
+    };
+}
@@ -2,20 +2,21 @@
 
 #include <QThread>
 
-#include <mongo/util/net/ssl_manager.h>
-#include <mongo/util/net/ssl_options.h>
-
 #include "robomongo/core/events/MongoEvents.h"
-#include "robomongo/core/engine/ScriptEngine.h"
 #include "robomongo/core/EventBus.h"
 #include "robomongo/core/AppRegistry.h"
 #include "robomongo/core/mongodb/MongoClient.h"
+#include "robomongo/core/mongodb/MongoConnectionPool.h"
+#include "robomongo/core/mongodb/ScriptWorker.h"
+#include "robomongo/core/mongodb/QueryWorker.h"
+#include "robomongo/core/mongodb/JobWorker.h"
+#include "robomongo/core/mongodb/CollectionStatsLoader.h"
+#include "robomongo/core/mongodb/WorkerThreadPool.h"
 #include "robomongo/core/settings/ConnectionSettings.h"
 #include "robomongo/core/domain/MongoShellResult.h"
 #include "robomongo/core/domain/MongoCollectionInfo.h"
 #include "robomongo/core/settings/CredentialSettings.h"
 #include "robomongo/core/settings/SettingsManager.h"
-#include "robomongo/core/settings/SslSettings.h"
 #include "robomongo/core/utils/Logger.h"
 #include "robomongo/core/utils/QtUtils.h"
 
@@ -24,22 +25,26 @@ namespace Robomongo
     MongoWorker::MongoWorker(ConnectionSettings *connection, bool isLoadMongoRcJs, int batchSize,
                              int mongoTimeoutSec, int shellTimeoutSec, QObject *parent) : QObject(parent),
         _connection(connection),
-        _scriptEngine(NULL),
-        _dbclient(NULL),
+        _scriptWorker(NULL),
+        _queryWorker(NULL),
+        _jobWorker(NULL),
+        _statsLoader(NULL),
+        _isInitialized(false),
         _isAdmin(true),
         _isLoadMongoRcJs(isLoadMongoRcJs),
         _batchSize(batchSize),
         _timerId(-1),
-        _dbAutocompleteCacheTimerId(-1),
         _mongoTimeoutSec(mongoTimeoutSec),
         _shellTimeoutSec(shellTimeoutSec),
         _isQuiting(0)
     {
-        _thread = new QThread();
+        // Thread is shared with other workers, so events of this worker
+        // are still handled one by one, in the order they were sent
+        _thread = AppRegistry::instance().workerThreadPool()->acquire();
         moveToThread(_thread);
-        VERIFY(connect( _thread, SIGNAL(finished()), _thread, SLOT(deleteLater()) ));
-        VERIFY(connect( _thread, SIGNAL(finished()), this, SLOT(deleteLater()) ));
-        _thread->start();
+
+        _queryWorker = new QueryWorker(_connection->clone(), _mongoTimeoutSec);
+        _statsLoader = new CollectionStatsLoader(_connection->clone(), _mongoTimeoutSec);
     }
 
     void MongoWorker::timerEvent(QTimerEvent *event)
@@ -48,34 +53,25 @@ namespace Robomongo
             keepAlive();
             return;
         }
-
-        if (_dbAutocompleteCacheTimerId == event->timerId() &&
-            _scriptEngine != NULL) {
-            _scriptEngine->invalidateDbCollectionsCache();
-            return;
-        }
     }
 
     void MongoWorker::keepAlive()
     {
         try {
-            if (_dbclient) {
-                // Building { ping: 1 }
-                mongo::BSONObjBuilder command;
-                command.append("ping", 1);
-                mongo::BSONObj result;
-                std::string authBase = getAuthBase();
-                if (authBase.empty()) {
-                    _dbclient->runCommand("admin", command.obj(), result);
-                } else {
-                    _dbclient->runCommand(authBase, command.obj(), result);
-                }
-            }
+            // Pinged connection returns to the pool, so idle sockets are kept alive.
+            // Shell connection is pinged by ScriptWorker.
+            boost::scoped_ptr<MongoClient> client(getClient());
 
-            if (_scriptEngine) {
-                _scriptEngine->ping();
+            // Building { ping: 1 }
+            mongo::BSONObjBuilder command;
+            command.append("ping", 1);
+            mongo::BSONObj result;
+            std::string authBase = getAuthBase();
+            if (authBase.empty()) {
+                client->connection()->runCommand("admin", command.obj(), result);
+            } else {
+                client->connection()->runCommand(authBase, command.obj(), result);
             }
-
         } catch(std::exception &ex) {
             LOG_MSG(ex.what(), mongo::logger::LogSeverity::Error());
         }
@@ -83,24 +79,21 @@ namespace Robomongo
 
     void MongoWorker::init()
     {        
-        try {
-            _scriptEngine = new ScriptEngine(_connection, _shellTimeoutSec);
-            _scriptEngine->init(_isLoadMongoRcJs);
-            _scriptEngine->use(_connection->defaultDatabase());
-            _scriptEngine->setBatchSize(_batchSize);
+        // ScriptWorker is started by the first script or autocomplete request,
+        // connections that are used only by explorer do not start MongoDB shell
+        _isInitialized = true;
+
+        if (_timerId == -1)
             _timerId = startTimer(pingTimeMs);
-            _dbAutocompleteCacheTimerId = startTimer(30000);
-        } catch (const std::exception &ex) {
-            LOG_MSG(ex.what(), mongo::logger::LogSeverity::Error());
-        }
     }
 
     void MongoWorker::interrupt() {
         try {
-            if (_isQuiting || !_scriptEngine)
+            QMutexLocker lock(&_lanesLock);
+            if (_isQuiting || !_scriptWorker)
                 return;
 
-            _scriptEngine->interrupt();
+            _scriptWorker->interrupt();
         } catch(const mongo::DBException &ex) {
             LOG_MSG(ex.what(), mongo::logger::LogSeverity::Error());
         }
@@ -111,21 +104,42 @@ namespace Robomongo
         if (_timerId != -1)
             killTimer(_timerId);
 
-        if (_dbAutocompleteCacheTimerId != -1)
-            killTimer(_dbAutocompleteCacheTimerId);
+        // Lanes are already stopped by stopAndDelete(). They are deleted here,
+        // because this worker may forward requests to them until now.
+        _queryWorker->stopAndDelete();
+        if (_jobWorker)
+            _jobWorker->stopAndDelete();
+        if (_scriptWorker)
+            _scriptWorker->stopAndDelete();
 
-        delete _dbclient;
+        delete _statsLoader;
         delete _connection;
-        delete _scriptEngine;
 
-        // QThread "_thread" and MongoWorker itself will be deleted later
-        // (see MongoWorker() constructor)
+        AppRegistry::instance().workerThreadPool()->release(_thread);
     }
 
     void MongoWorker::stopAndDelete()
     {
-        _isQuiting = 1;
-        _thread->quit();
+        {
+            // Lanes may be handling requests of deleted senders right now
+            QMutexLocker lock(&_lanesLock);
+            _isQuiting = 1;
+            _queryWorker->stop();
+            if (_jobWorker)
+                _jobWorker->stop();
+            if (_scriptWorker)
+                _scriptWorker->stop();
+        }
+        _statsLoader->cancel();
+
+        // Thread belongs to the pool and is not stopped. Events that were
+        // already sent to this worker are handled before it is deleted.
+        deleteLater();
+    }
+
+    void MongoWorker::cancelCollectionStats(QObject *receiver)
+    {
+        _statsLoader->cancel(receiver);
     }
 
     /**
@@ -136,6 +150,7 @@ namespace Robomongo
         QMutexLocker lock(&_firstConnectionMutex);
 
         try {
+            // Connection from the pool is already authenticated
             mongo::DBClientBase *conn = getConnection(true);
             if (conn == NULL) {
                 reply(event->sender(), new EstablishConnectionResponse(this,
@@ -144,19 +159,11 @@ namespace Robomongo
                 return;
             }
 
+            boost::scoped_ptr<MongoClient> client(new MongoClient(conn, AppRegistry::instance().connectionPool()));
+
             if (_connection->hasEnabledPrimaryCredential()) {
                 CredentialSettings *credentials = _connection->primaryCredential();
 
-                // Building BSON object:
-                mongo::BSONObj authParams(mongo::BSONObjBuilder()
-                    .append("user", credentials->userName())
-                    .append("db", credentials->databaseName())
-                    .append("pwd", credentials->userPassword())
-                    .append("mechanism", credentials->mechanism())
-                    .obj());
-
-                conn->auth(authParams);
-
                 // If authentication succeed and database name is 'admin' -
                 // then user is admin, otherwise user is not admin
                 std::string dbName = credentials->databaseName();
@@ -165,13 +172,15 @@ namespace Robomongo
                     _isAdmin = false;
             }
 
-            boost::scoped_ptr<MongoClient> client(getClient());
-            std::vector<std::string> dbNames = getDatabaseNamesSafe();
+            std::vector<std::string> dbNames;
+            if (event->loadDatabases) {
+                dbNames = getDatabaseNamesSafe();
 
-            // If we do not have databases, it means that we are unable to
-            // execute "listdatabases" command and we have nothing to show.
-            if (dbNames.size() == 0)
-                throw mongo::DBException("Failed to execute \"listdatabases\" command.", 0);
+                // If we do not have databases, it means that we are unable to
+                // execute "listdatabases" command and we have nothing to show.
+                if (dbNames.size() == 0)
+                    throw mongo::DBException("Failed to execute \"listdatabases\" command.", 0);
+            }
 
             init();
 
@@ -252,9 +261,16 @@ namespace Robomongo
             boost::scoped_ptr<MongoClient> client(getClient());
 
             std::vector<std::string> stringList = client->getCollectionNames(event->databaseName());
-            const std::vector<MongoCollectionInfo> &infos = client->runCollStatsCommand(stringList);
             client->done();
 
+            // Statistics are loaded later, see LoadCollectionStatsRequest
+            std::vector<MongoCollectionInfo> infos;
+            for (std::vector<std::string>::const_iterator it = stringList.begin(); it != stringList.end(); ++it) {
+                MongoCollectionInfo info(*it);
+                if (info.ns().isValid())
+                    infos.push_back(info);
+            }
+
             reply(event->sender(), new LoadCollectionNamesResponse(this, event->databaseName(), infos));
         } catch(const mongo::DBException &ex) {
             reply(event->sender(), new LoadCollectionNamesResponse(this, EventError(ex.what())));
@@ -262,6 +278,11 @@ namespace Robomongo
         }
     }
 
+    void MongoWorker::handle(LoadCollectionStatsRequest *event)
+    {
+        _statsLoader->load(this, event->sender(), event->namespaces());
+    }
+
     void MongoWorker::handle(LoadUsersRequest *event)
     {
         try {
@@ -351,52 +372,32 @@ namespace Robomongo
 
     void MongoWorker::handle(InsertDocumentRequest *event)
     {
-        try {
-            boost::scoped_ptr<MongoClient> client(getClient());
-
-            if (event->overwrite())
-                client->saveDocument(event->obj(), event->ns());
-            else
-                client->insertDocument(event->obj(), event->ns());
-
-            client->done();
+        toLane(_queryWorker, new InsertDocumentRequest(*event), Qt::HighEventPriority);
+    }
 
-            reply(event->sender(), new InsertDocumentResponse(this));
-        } catch(const mongo::DBException &ex) {
-            EventError error = EventError("Error when saving document: " + ex.toString());
-            reply(event->sender(), new InsertDocumentResponse(this, error));
-            LOG_MSG(ex.what(), mongo::logger::LogSeverity::Error());
-        }
+    void MongoWorker::handle(InsertDocumentsRequest *event)
+    {
+        toLane(_queryWorker, new InsertDocumentsRequest(*event), Qt::HighEventPriority);
     }
 
     void MongoWorker::handle(RemoveDocumentRequest *event)
     {
-        try {
-            boost::scoped_ptr<MongoClient> client(getClient());
-
-            client->removeDocuments(event->ns(), event->query(), event->justOne());
-            client->done();
+        toLane(_queryWorker, new RemoveDocumentRequest(*event), Qt::HighEventPriority);
+    }
 
-            reply(event->sender(), new RemoveDocumentResponse(this));
-        } catch(const mongo::DBException &ex) {
-            EventError error = EventError("Error when deleting document: " + ex.toString());
-            reply(event->sender(), new RemoveDocumentResponse(this, error));
-            LOG_MSG(ex.what(), mongo::logger::LogSeverity::Error());
-        }
+    void MongoWorker::handle(RemoveDocumentsByIdRequest *event)
+    {
+        toLane(_queryWorker, new RemoveDocumentsByIdRequest(*event), Qt::HighEventPriority);
     }
 
     void MongoWorker::handle(ExecuteQueryRequest *event)
     {
-        try {
-            boost::scoped_ptr<MongoClient> client(getClient());
-            std::vector<MongoDocumentPtr> docs = client->query(event->queryInfo());
-            client->done();
+        toLane(_queryWorker, new ExecuteQueryRequest(*event), Qt::HighEventPriority);
+    }
 
-            reply(event->sender(), new ExecuteQueryResponse(this, event->resultIndex(), event->queryInfo(), docs));
-        } catch(const mongo::DBException &ex) {
-            reply(event->sender(), new ExecuteQueryResponse(this, EventError(ex.what())));
-            LOG_MSG(ex.what(), mongo::logger::LogSeverity::Error());
-        }
+    void MongoWorker::handle(CloseQueryCursorsRequest *event)
+    {
+        toLane(_queryWorker, new CloseQueryCursorsRequest(*event), Qt::HighEventPriority);
     }
 
     /**
@@ -404,18 +405,13 @@ namespace Robomongo
      */
     void MongoWorker::handle(ExecuteScriptRequest *event)
     {
-        try {
-            if (!_scriptEngine) {
-                reply(event->sender(), new ExecuteScriptResponse(this, EventError("MongoDB Shell was not initialized")));
-                return;
-            }
-
-            MongoShellExecResult result = _scriptEngine->exec(event->script, event->databaseName);
-            reply(event->sender(), new ExecuteScriptResponse(this, result, event->script.empty()));
-        } catch(const mongo::DBException &ex) {
-            reply(event->sender(), new ExecuteScriptResponse(this, EventError(ex.what())));
-            LOG_MSG(ex.what(), mongo::logger::LogSeverity::Error());
+        if (!_isInitialized) {
+            reply(event->sender(), new ExecuteScriptResponse(this, EventError("MongoDB Shell was not initialized")));
+            return;
         }
+
+        // Script may run for a long time, it should not hold the shared thread
+        toLane(scriptWorker(), new ExecuteScriptRequest(*event));
     }
 
     /**
@@ -423,31 +419,17 @@ namespace Robomongo
      */
     void MongoWorker::handle(StopScriptRequest *)
     {
-        try {
-            if (!_scriptEngine) {
-                return;
-            }
-
-            _scriptEngine->interrupt();
-        } catch(const mongo::DBException &ex) {
-            LOG_MSG(ex.what(), mongo::logger::LogSeverity::Error());
-        }
+        interrupt();
     }
 
     void MongoWorker::handle(AutocompleteRequest *event)
     {
-        try {
-            if (!_scriptEngine) {
-                reply(event->sender(), new AutocompleteResponse(this, EventError("MongoDB Shell was not initialized")));
-                return;
-            }
-
-            QStringList list = _scriptEngine->complete(event->prefix, event->mode);
-            reply(event->sender(), new AutocompleteResponse(this, list, event->prefix));
-        } catch(const mongo::DBException &ex) {
-            reply(event->sender(), new AutocompleteResponse(this, EventError(ex.what())));
-            LOG_MSG(ex.what(), mongo::logger::LogSeverity::Error());
+        if (!_isInitialized) {
+            reply(event->sender(), new AutocompleteResponse(this, EventError("MongoDB Shell was not initialized")));
+            return;
         }
+
+        toLane(scriptWorker(), new AutocompleteRequest(*event), Qt::HighEventPriority);
     }
 
     void MongoWorker::handle(CreateDatabaseRequest *event)
@@ -505,6 +487,7 @@ namespace Robomongo
             boost::scoped_ptr<MongoClient> client(getClient());
             client->dropCollection(event->ns());
             client->done();
+            _statsLoader->invalidate(event->ns().toString());
 
             reply(event->sender(), new DropCollectionResponse(this));
         } catch(const mongo::DBException &ex) {
@@ -519,6 +502,8 @@ namespace Robomongo
             boost::scoped_ptr<MongoClient> client(getClient());
             client->renameCollection(event->ns(), event->newCollection());
             client->done();
+            _statsLoader->invalidate(event->ns().toString());
+            _statsLoader->invalidate(MongoNamespace(event->ns().databaseName(), event->newCollection()).toString());
 
             reply(event->sender(), new RenameCollectionResponse(this));
         } catch(const mongo::DBException &ex) {
@@ -529,31 +514,14 @@ namespace Robomongo
 
     void MongoWorker::handle(DuplicateCollectionRequest *event)
     {
-        try {
-            boost::scoped_ptr<MongoClient> client(getClient());
-            client->duplicateCollection(event->ns(), event->newCollection());
-            client->done();
-
-            reply(event->sender(), new DuplicateCollectionResponse(this));
-        } catch(const mongo::DBException &ex) {
-            reply(event->sender(), new DuplicateCollectionResponse(this, EventError(ex.what())));
-            LOG_MSG(ex.what(), mongo::logger::LogSeverity::Error());
-        }
+        _statsLoader->invalidate(MongoNamespace(event->ns().databaseName(), event->newCollection()).toString());
+        toLane(jobWorker(), new DuplicateCollectionRequest(*event));
     }
 
     void MongoWorker::handle(CopyCollectionToDiffServerRequest *event)
     {
-        try {
-            boost::scoped_ptr<MongoClient> client(getClient());
-            MongoWorker *cl = event->worker();
-            client->copyCollectionToDiffServer(cl->_dbclient, event->from(), event->to());
-            client->done();
-
-            reply(event->sender(), new CopyCollectionToDiffServerResponse(this));
-        } catch(const mongo::DBException &ex) {
-            reply(event->sender(), new CopyCollectionToDiffServerResponse(this, EventError(ex.what())));
-            LOG_MSG(ex.what(), mongo::logger::LogSeverity::Error());
-        }
+        _statsLoader->invalidate(event->to().toString());
+        toLane(jobWorker(), new CopyCollectionToDiffServerRequest(*event));
     }
 
     void MongoWorker::handle(CreateUserRequest *event)
@@ -614,51 +582,39 @@ namespace Robomongo
 
     mongo::DBClientBase *MongoWorker::getConnection(bool mayReturnNull /* = false */)
     {
-        if (!_dbclient) {
-            // Timeout for operations
-            // Connect timeout is fixed, but short, at 5 seconds (see headers for DBClientConnection)
-            mongo::DBClientConnection *conn = new mongo::DBClientConnection(true, _mongoTimeoutSec);
-
-            // Update global mongo SSL settings according to SSL enable/disabled status
-            if (_connection->sslSettings()->sslEnabled())
-            {
-                // Force SSL mode for outgoing connections
-                mongo::sslGlobalParams.sslMode.store(mongo::SSLParams::SSLMode_requireSSL);
-                writeGlobalSSLparams();
-            }
-            else
-            {
-                // Disable forced SSL mode for outgoing connections
-                mongo::sslGlobalParams.sslMode.store(mongo::SSLParams::SSLMode_allowSSL);
-            }
-
-            mongo::Status status = conn->connect(_connection->info());
-
-            if (!status.isOK() && mayReturnNull) {
-                delete conn;
-                return NULL;
-            }
-
-            _dbclient = conn;
-        }
-        return _dbclient;
+        return AppRegistry::instance().connectionPool()->acquire(_connection, _mongoTimeoutSec, mayReturnNull);
     }
 
     MongoClient *MongoWorker::getClient()
     {
-        return new MongoClient(getConnection());
+        MongoClient *client = new MongoClient(getConnection(), AppRegistry::instance().connectionPool());
+        client->setWriteConcern(_connection->writeConcern());
+        return client;
     }
 
-    void MongoWorker::writeGlobalSSLparams() const
+    ScriptWorker *MongoWorker::scriptWorker()
     {
-        const SslSettings * const sslSettings = _connection->sslSettings();
-        mongo::sslGlobalParams.sslCAFile = sslSettings->caFile();
-        mongo::sslGlobalParams.sslPEMKeyFile = sslSettings->pemKeyFile();
-        mongo::sslGlobalParams.sslPEMKeyPassword =
-            sslSettings->pemKeyEncrypted() ? sslSettings->pemPassPhrase() : "";
-        mongo::sslGlobalParams.sslAllowInvalidCertificates = sslSettings->allowInvalidCertificates();
-        mongo::sslGlobalParams.sslCRLFile = sslSettings->crlFile();
-        mongo::sslGlobalParams.sslAllowInvalidHostnames = sslSettings->allowInvalidHostnames();
+        QMutexLocker lock(&_lanesLock);
+        if (_isQuiting)
+            return NULL;
+
+        // JS scope is initialized in the thread of ScriptWorker
+        if (!_scriptWorker)
+            _scriptWorker = new ScriptWorker(_connection->clone(), _isLoadMongoRcJs, _batchSize, _shellTimeoutSec);
+
+        return _scriptWorker;
+    }
+
+    JobWorker *MongoWorker::jobWorker()
+    {
+        QMutexLocker lock(&_lanesLock);
+        if (_isQuiting)
+            return NULL;
+
+        if (!_jobWorker)
+            _jobWorker = new JobWorker(_connection->clone(), _mongoTimeoutSec);
+
+        return _jobWorker;
     }
 
     /**
@@ -672,6 +628,20 @@ namespace Robomongo
         AppRegistry::instance().bus()->send(this, event);
     }
 
+    /**
+     * @brief Forward request to one of the lanes. Sender of request
+     * is kept, so lane replies directly to it.
+     */
+    void MongoWorker::toLane(QObject *lane, Event *event, int priority /* = Qt::NormalEventPriority */)
+    {
+        if (_isQuiting || !lane) {
+            delete event;
+            return;
+        }
+
+        AppRegistry::instance().bus()->send(lane, event, priority);
+    }
+
     /**
      * @brief Send reply event to object 'receiver'
      */
@@ -14,9 +14,28 @@ QT_END_NAMESPACE
 namespace Robomongo
 {
     class MongoClient;
-    class ScriptEngine;
+    class ScriptWorker;
+    class QueryWorker;
+    class JobWorker;
+    class CollectionStatsLoader;
     class ConnectionSettings;
 
+    /**
+     * @brief Handles requests of one connection. Workers do not own threads:
+     * every worker is moved to a thread of WorkerThreadPool and its events are
+     * processed one by one by that thread.
+     *
+     * Requests are split into lanes, each lane has its own queue and borrows
+     * its own connections, so that long operations do not block others:
+     *  - metadata (explorer loads, DDL) is handled by MongoWorker itself;
+     *  - interactive queries and document edits go to QueryWorker, with high priority;
+     *  - long-running jobs (copying of collections) go to JobWorker;
+     *  - statistics of collections are loaded by CollectionStatsLoader;
+     *  - MongoDB shell runs in ScriptWorker.
+     *
+     * JobWorker and ScriptWorker have dedicated threads, so they are created
+     * on the first request they handle.
+     */
     class MongoWorker : public QObject
     {
         Q_OBJECT
@@ -28,7 +47,18 @@ namespace Robomongo
         ~MongoWorker();
         enum { pingTimeMs = 60 * 1000 };
         void interrupt();
+
+        /**
+         * @brief Stops this worker and its lanes immediately, so that none of them
+         * replies to senders of requests any more. Worker is deleted later, in its thread.
+         */
         void stopAndDelete();
+        ConnectionSettings *connectionSettings() const { return _connection; }
+
+        /**
+         * @brief Stops sending statistics of collections to 'receiver', may be called from any thread
+         */
+        void cancelCollectionStats(QObject *receiver);
         
     protected Q_SLOTS: // handlers:
         void init();
@@ -53,6 +83,12 @@ namespace Robomongo
          */
         void handle(LoadCollectionNamesRequest *event);
 
+        /**
+         * @brief Statistics of collections are loaded in the background
+         * by CollectionStatsLoader
+         */
+        void handle(LoadCollectionStatsRequest *event);
+
         /**
          * @brief Load list of all users
          */
@@ -84,26 +120,24 @@ namespace Robomongo
         void handle(LoadFunctionsRequest *event);
 
         /**
-         * @brief Inserts document
+         * @brief Queries and document edits are forwarded to QueryWorker
          */
         void handle(InsertDocumentRequest *event);
-
-        /**
-         * @brief Remove documents
-         */
+        void handle(InsertDocumentsRequest *event);
         void handle(RemoveDocumentRequest *event);
-
-        /**
-         * @brief Load list of all collection names
-         */
+        void handle(RemoveDocumentsByIdRequest *event);
         void handle(ExecuteQueryRequest *event);
+        void handle(CloseQueryCursorsRequest *event);
 
         /**
-         * @brief Execute javascript
+         * @brief Execute javascript. Script is forwarded to ScriptWorker.
          */
         void handle(ExecuteScriptRequest *event);
         void handle(StopScriptRequest *event);
 
+        /**
+         * @brief Autocomplete is forwarded to ScriptWorker.
+         */
         void handle(AutocompleteRequest *event);
         void handle(CreateDatabaseRequest *event);
         void handle(DropDatabaseRequest *event);
@@ -111,6 +145,10 @@ namespace Robomongo
         void handle(CreateCollectionRequest *event);
         void handle(DropCollectionRequest *event);
         void handle(RenameCollectionRequest *event);
+
+        /**
+         * @brief Copying of collections is forwarded to JobWorker
+         */
         void handle(DuplicateCollectionRequest *event);
         void handle(CopyCollectionToDiffServerRequest *event);
 
@@ -131,30 +169,45 @@ namespace Robomongo
         DatabasesContainerType getDatabaseNamesSafe();
         std::string getAuthBase() const;
 
-        mongo::DBClientBase *_dbclient;
+        /**
+         * @brief Borrows connection from the pool. Connection should be returned
+         * to the pool after request, MongoClient from getClient() does it on destruction.
+         */
         mongo::DBClientBase *getConnection(bool mayReturnNull = false);
         MongoClient *getClient();
 
         /**
-        *@brief Update global mongo SSL settings (mongo::sslGlobalParams) according to active connection 
-        *       request's SSL settings.
-        */
-        void writeGlobalSSLparams() const;
+         * @brief Lanes with dedicated threads, created on first use.
+         * @return NULL, if worker is stopped
+         */
+        ScriptWorker *scriptWorker();
+        JobWorker *jobWorker();
+
+        /**
+         * @brief Forward request to one of the lanes
+         */
+        void toLane(QObject *lane, Event *event, int priority = Qt::NormalEventPriority);
 
         /**
          * @brief Send reply event to object 'obj'
          */
         void reply(QObject *receiver, Event *event);
-        QThread *_thread;
+        QThread *_thread;   // thread of WorkerThreadPool
         QMutex _firstConnectionMutex;
 
-        ScriptEngine *_scriptEngine;
+        // Lanes are stopped from the thread that calls stopAndDelete(), _lanesLock
+        // guards lanes created on first use and setting of _isQuiting
+        QMutex _lanesLock;
+        ScriptWorker *_scriptWorker;
+        QueryWorker *_queryWorker;
+        JobWorker *_jobWorker;
+        CollectionStatsLoader *_statsLoader;
 
+        bool _isInitialized;    // connection is established, MongoDB shell can be started
         bool _isAdmin;
         const bool _isLoadMongoRcJs;
         const int _batchSize;
         int _timerId;
-        int _dbAutocompleteCacheTimerId;
         int _mongoTimeoutSec;
         int _shellTimeoutSec;
         QAtomicInteger<int> _isQuiting;
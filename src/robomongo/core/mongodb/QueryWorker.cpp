@@ -0,0 +1,285 @@
+#include "robomongo/core/mongodb/QueryWorker.h"
+
+#include <limits>
+#include <QThread>
+#include <QDateTime>
+
+#include "robomongo/core/EventBus.h"
+#include "robomongo/core/AppRegistry.h"
+#include "robomongo/core/mongodb/MongoClient.h"
+#include "robomongo/core/mongodb/MongoConnectionPool.h"
+#include "robomongo/core/mongodb/WorkerThreadPool.h"
+#include "robomongo/core/settings/ConnectionSettings.h"
+#include "robomongo/core/utils/Logger.h"
+
+namespace Robomongo
+{
+    QueryWorker::QueryWorker(ConnectionSettings *connection, int mongoTimeoutSec) : QObject(),
+        _connection(connection),
+        _mongoTimeoutSec(mongoTimeoutSec),
+        _timerId(-1),
+        _isQuiting(0)
+    {
+        _thread = AppRegistry::instance().workerThreadPool()->acquire();
+        moveToThread(_thread);
+    }
+
+    QueryWorker::~QueryWorker()
+    {
+        if (_timerId != -1)
+            killTimer(_timerId);
+
+        // Cursors are killed and their connections are returned to the pool
+        _queryCursors.clear();
+
+        delete _connection;
+
+        AppRegistry::instance().workerThreadPool()->release(_thread);
+    }
+
+    void QueryWorker::stop()
+    {
+        _isQuiting = 1;
+    }
+
+    void QueryWorker::stopAndDelete()
+    {
+        _isQuiting = 1;
+        deleteLater();
+    }
+
+    void QueryWorker::timerEvent(QTimerEvent *event)
+    {
+        if (_timerId == event->timerId()) {
+            killIdleQueryCursors();
+            return;
+        }
+    }
+
+    void QueryWorker::handle(InsertDocumentRequest *event)
+    {
+        try {
+            boost::scoped_ptr<MongoClient> client(getClient());
+
+            if (event->overwrite())
+                client->saveDocument(event->obj(), event->ns());
+            else
+                client->insertDocument(event->obj(), event->ns());
+
+            client->done();
+
+            reply(event->sender(), new InsertDocumentResponse(this));
+        } catch(const mongo::DBException &ex) {
+            EventError error = EventError("Error when saving document: " + ex.toString());
+            reply(event->sender(), new InsertDocumentResponse(this, error));
+            LOG_MSG(ex.what(), mongo::logger::LogSeverity::Error());
+        }
+    }
+
+    void QueryWorker::handle(InsertDocumentsRequest *event)
+    {
+        try {
+            boost::scoped_ptr<MongoClient> client(getClient());
+
+            std::vector<DocumentWriteError> errors;
+            int inserted = client->insertDocuments(event->ns(), event->objs(), event->ordered(), errors);
+            client->done();
+
+            reply(event->sender(), new InsertDocumentsResponse(this, event->ns(), inserted, errors, client->writeConcernError()));
+        } catch(const mongo::DBException &ex) {
+            EventError error = EventError("Error when inserting documents: " + ex.toString());
+            reply(event->sender(), new InsertDocumentsResponse(this, event->ns(), error));
+            LOG_MSG(ex.what(), mongo::logger::LogSeverity::Error());
+        }
+    }
+
+    void QueryWorker::handle(RemoveDocumentRequest *event)
+    {
+        try {
+            boost::scoped_ptr<MongoClient> client(getClient());
+
+            client->removeDocuments(event->ns(), event->query(), event->justOne());
+            client->done();
+
+            reply(event->sender(), new RemoveDocumentResponse(this));
+        } catch(const mongo::DBException &ex) {
+            EventError error = EventError("Error when deleting document: " + ex.toString());
+            reply(event->sender(), new RemoveDocumentResponse(this, error));
+            LOG_MSG(ex.what(), mongo::logger::LogSeverity::Error());
+        }
+    }
+
+    void QueryWorker::handle(RemoveDocumentsByIdRequest *event)
+    {
+        try {
+            boost::scoped_ptr<MongoClient> client(getClient());
+
+            client->removeDocumentsById(event->ns(), event->ids());
+            client->done();
+
+            reply(event->sender(), new RemoveDocumentResponse(this));
+        } catch(const mongo::DBException &ex) {
+            EventError error = EventError("Error when deleting documents: " + ex.toString());
+            reply(event->sender(), new RemoveDocumentResponse(this, error));
+            LOG_MSG(ex.what(), mongo::logger::LogSeverity::Error());
+        }
+    }
+
+    void QueryWorker::handle(ExecuteQueryRequest *event)
+    {
+        const MongoQueryInfo info = event->queryInfo();
+        const QueryCursorKey key(event->sender(), event->resultIndex());
+
+        try {
+            // Continue cursor of the previous page, if this is the next one.
+            // Cursor stays on the connection it was opened with.
+            QueryCursor queryCursor = takeQueryCursor(key, info);
+            boost::shared_ptr<MongoClient> client = queryCursor.client;
+            boost::shared_ptr<mongo::DBClientCursor> cursor = queryCursor.cursor;
+            int endSkip = queryCursor.endSkip;
+            if (!cursor) {
+                // Cursor may serve several next pages. Its limit is kept on the server,
+                // so sort without index is still a top-k sort and not a full one.
+                // Number of documents per page is controlled below.
+                MongoQueryInfo cursorInfo(info);
+                if (cursorInfo._limit > 0 && cursorInfo._limit <= std::numeric_limits<int>::max() / cursorPagesCount)
+                    cursorInfo._limit = info._limit * cursorPagesCount;
+                endSkip = info._skip + cursorInfo._limit;
+                client.reset(getClient());
+                cursor.reset(client->openCursor(cursorInfo, isKeysetAllowed(client.get(), info)).release());
+            }
+
+            // Every batch received from the server is sent to the GUI immediately,
+            // so the first documents are shown before the whole page is read.
+            int remaining = info._limit; // 0 means read until the end
+            int loaded = 0;
+            bool firstBatch = true;
+            bool lastBatch = false;
+            while (cursor && !lastBatch && !_isQuiting && cursor->more()) {
+                std::vector<MongoDocumentPtr> docs = client->nextBatch(cursor.get(), remaining);
+                loaded += docs.size();
+                if (remaining > 0)
+                    remaining -= docs.size();
+
+                lastBatch = (info._limit > 0 && remaining == 0) || (cursor->isDead() && !cursor->moreInCurrentBatch());
+                reply(event->sender(), new ExecuteQueryResponse(this, event->resultIndex(), info, docs, firstBatch, lastBatch));
+                firstBatch = false;
+            }
+            client->done();
+
+            // Keep cursor alive for the next page, unless it reached its limit
+            int nextSkip = info._skip + loaded;
+            if (cursor && info._limit > 0 && nextSkip < endSkip && (!cursor->isDead() || cursor->moreInCurrentBatch())) {
+                // Connection of kept cursor does not take place of other requests in the pool
+                client->keepConnection();
+
+                QueryCursor &nextCursor = _queryCursors[key];
+                nextCursor.client = client;
+                nextCursor.cursor = cursor;
+                nextCursor.queryInfo = info;
+                nextCursor.nextSkip = nextSkip;
+                nextCursor.endSkip = endSkip;
+                nextCursor.lastAccessMs = QDateTime::currentMSecsSinceEpoch();
+
+                if (_timerId == -1)
+                    _timerId = startTimer(cursorsCheckTimeMs);
+            }
+
+            // Let the GUI know that there is nothing more to wait for
+            if (!lastBatch)
+                reply(event->sender(), new ExecuteQueryResponse(this, event->resultIndex(), info, std::vector<MongoDocumentPtr>(), firstBatch, true));
+        } catch(const mongo::DBException &ex) {
+            _queryCursors.erase(key);
+            reply(event->sender(), new ExecuteQueryResponse(this, EventError(ex.what())));
+            LOG_MSG(ex.what(), mongo::logger::LogSeverity::Error());
+        }
+    }
+
+    void QueryWorker::handle(CloseQueryCursorsRequest *event)
+    {
+        QueryCursorsContainerType::iterator it = _queryCursors.begin();
+        while (it != _queryCursors.end()) {
+            if (it->first.first == event->sender())
+                it = _queryCursors.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    QueryWorker::QueryCursor QueryWorker::takeQueryCursor(const QueryCursorKey &key, const MongoQueryInfo &info)
+    {
+        QueryCursor result;
+
+        QueryCursorsContainerType::iterator it = _queryCursors.find(key);
+        if (it == _queryCursors.end())
+            return result;
+
+        const QueryCursor &prev = it->second;
+        bool sameQuery = prev.queryInfo._info._ns.toString() == info._info._ns.toString()
+            && prev.queryInfo._query.binaryEqual(info._query)
+            && prev.queryInfo._fields.binaryEqual(info._fields)
+            && prev.queryInfo._options == info._options
+            && prev.queryInfo._batchSize == info._batchSize
+            && prev.queryInfo._limit == info._limit;   // pages stay within limit of cursor
+
+        if (sameQuery && prev.nextSkip == info._skip && info._limit > 0)
+            result = prev;
+
+        // Destroying DBClientCursor kills server cursor, if it is still alive.
+        // After that connection of the cursor is returned to the pool.
+        _queryCursors.erase(it);
+        return result;
+    }
+
+    bool QueryWorker::isKeysetAllowed(MongoClient *client, const MongoQueryInfo &info)
+    {
+        mongo::BSONElement boundary = info._boundary.firstElement();
+        mongo::BSONObj sortOrder = info.sortOrder();
+        if (boundary.eoo() || sortOrder.nFields() != 1)
+            return false;
+
+        std::string fieldName = sortOrder.firstElementFieldName();
+        if (fieldName != boundary.fieldName())
+            return false;
+
+        qint64 now = QDateTime::currentMSecsSinceEpoch();
+        KeysetCheck &check = _keysetChecks[KeysetCheckKey(info._info._ns.toString(), fieldName)];
+        if (now - check.checkedMs > keysetCheckTimeMs) {
+            // $gt and $lt match only values of the same type as boundary,
+            // so range query would skip documents with keys of other types
+            check.isAllowed = client->isUniqueIndexKey(info._info._ns, fieldName)
+                && client->hasSingleKeyType(info._info._ns, fieldName, check.canonicalType);
+            check.checkedMs = now;
+        }
+
+        return check.isAllowed && check.canonicalType == boundary.canonicalType();
+    }
+
+    void QueryWorker::killIdleQueryCursors()
+    {
+        qint64 now = QDateTime::currentMSecsSinceEpoch();
+        QueryCursorsContainerType::iterator it = _queryCursors.begin();
+        while (it != _queryCursors.end()) {
+            if (now - it->second.lastAccessMs > queryCursorIdleTimeMs)
+                it = _queryCursors.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    MongoClient *QueryWorker::getClient()
+    {
+        MongoConnectionPool *pool = AppRegistry::instance().connectionPool();
+        MongoClient *client = new MongoClient(pool->acquire(_connection, _mongoTimeoutSec), pool);
+        client->setWriteConcern(_connection->writeConcern());
+        return client;
+    }
+
+    void QueryWorker::reply(QObject *receiver, Event *event)
+    {
+        if (_isQuiting)
+            return;
+
+        AppRegistry::instance().bus()->send(receiver, event);
+    }
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <QObject>
+#include <map>
+#include <boost/shared_ptr.hpp>
+
+#include "robomongo/core/events/MongoEvents.h"
+
+QT_BEGIN_NAMESPACE
+class QThread;
+QT_END_NAMESPACE
+
+namespace mongo
+{
+    class DBClientCursor;
+}
+
+namespace Robomongo
+{
+    class MongoClient;
+    class ConnectionSettings;
+
+    /**
+     * @brief Interactive lane of a connection: queries, paging and editing
+     *        of single documents. Requests are forwarded here by MongoWorker
+     *        with high priority, so they are not waiting for explorer loads
+     *        or bulk jobs. QueryWorker lives on a thread of WorkerThreadPool
+     *        and borrows its own connections from MongoConnectionPool.
+     */
+    class QueryWorker : public QObject
+    {
+        Q_OBJECT
+
+    public:
+        /**
+         * @param connection: QueryWorker takes ownership of this settings.
+         */
+        QueryWorker(ConnectionSettings *connection, int mongoTimeoutSec);
+        ~QueryWorker();
+        enum { queryCursorIdleTimeMs = 5 * 60 * 1000, cursorsCheckTimeMs = 60 * 1000 };
+
+        /**
+         * @brief Cursor is opened with limit of this number of pages, so that the server
+         * still sorts only the top documents. Next cursor is opened after the last page.
+         */
+        enum { cursorPagesCount = 10 };
+
+        /**
+         * @brief Time, while result of checking of sort key for keyset paging is used
+         */
+        enum { keysetCheckTimeMs = 60 * 1000 };
+
+        /**
+         * @brief Stops replying to senders of requests, may be called from any thread
+         */
+        void stop();
+        void stopAndDelete();
+
+    protected Q_SLOTS: // handlers:
+        /**
+         * @brief Inserts document
+         */
+        void handle(InsertDocumentRequest *event);
+        void handle(InsertDocumentsRequest *event);
+
+        /**
+         * @brief Remove documents
+         */
+        void handle(RemoveDocumentRequest *event);
+        void handle(RemoveDocumentsByIdRequest *event);
+
+        /**
+         * @brief Load page of documents
+         */
+        void handle(ExecuteQueryRequest *event);
+
+        /**
+         * @brief Kill cursors kept for paging of closed result panes
+         */
+        void handle(CloseQueryCursorsRequest *event);
+
+    protected:
+        virtual void timerEvent(QTimerEvent *);
+
+    private:
+        /**
+         * @brief Open server cursor kept between pages of one result pane,
+         * so that next page is loaded with getMore instead of new query with skip.
+         */
+        struct QueryCursor
+        {
+            QueryCursor() : nextSkip(0), endSkip(0), lastAccessMs(0) {}
+
+            // Cursor is destroyed before the client, which returns connection to pool
+            boost::shared_ptr<MongoClient> client;
+            boost::shared_ptr<mongo::DBClientCursor> cursor;
+            MongoQueryInfo queryInfo;
+            int nextSkip;           // skip of the page that cursor will return next
+            int endSkip;            // skip after the last document within limit of cursor
+            qint64 lastAccessMs;
+        };
+        typedef std::pair<QObject *, int> QueryCursorKey; // receiver and result index
+        typedef std::map<QueryCursorKey, QueryCursor> QueryCursorsContainerType;
+
+        /**
+         * @brief Returns cursor that continues query 'info', or empty QueryCursor.
+         * Cursor that cannot be continued is killed.
+         */
+        QueryCursor takeQueryCursor(const QueryCursorKey &key, const MongoQueryInfo &info);
+        void killIdleQueryCursors();
+
+        /**
+         * @brief Result of checking of sort key of collection, see isKeysetAllowed()
+         */
+        struct KeysetCheck
+        {
+            KeysetCheck() : isAllowed(false), canonicalType(0), checkedMs(0) {}
+
+            bool isAllowed;         // key is unique and has the same type in all documents
+            int canonicalType;
+            qint64 checkedMs;
+        };
+        typedef std::pair<std::string, std::string> KeysetCheckKey; // namespace and sort field
+        typedef std::map<KeysetCheckKey, KeysetCheck> KeysetChecksContainerType;
+
+        /**
+         * @brief Whether next page of 'info' can be loaded by range query on sort key.
+         * Result of checking of collection is cached for keysetCheckTimeMs.
+         */
+        bool isKeysetAllowed(MongoClient *client, const MongoQueryInfo &info);
+
+        MongoClient *getClient();
+
+        /**
+         * @brief Send reply event to object 'receiver'
+         */
+        void reply(QObject *receiver, Event *event);
+
+        QThread *_thread;   // thread of WorkerThreadPool
+        ConnectionSettings *_connection;
+        const int _mongoTimeoutSec;
+        int _timerId;
+        QAtomicInteger<int> _isQuiting;
+
+        QueryCursorsContainerType _queryCursors;
+        KeysetChecksContainerType _keysetChecks;
+    };
+}
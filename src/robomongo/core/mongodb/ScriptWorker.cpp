@@ -0,0 +1,146 @@
+#include "robomongo/core/mongodb/ScriptWorker.h"
+
+#include <QThread>
+
+#include "robomongo/core/engine/ScriptEngine.h"
+#include "robomongo/core/EventBus.h"
+#include "robomongo/core/AppRegistry.h"
+#include "robomongo/core/settings/ConnectionSettings.h"
+#include "robomongo/core/utils/Logger.h"
+#include "robomongo/core/utils/QtUtils.h"
+
+namespace Robomongo
+{
+    ScriptWorker::ScriptWorker(ConnectionSettings *connection, bool isLoadMongoRcJs, int batchSize, int shellTimeoutSec) : QObject(),
+        _scriptEngine(NULL),
+        _connection(connection),
+        _isLoadMongoRcJs(isLoadMongoRcJs),
+        _batchSize(batchSize),
+        _shellTimeoutSec(shellTimeoutSec),
+        _timerId(-1),
+        _dbAutocompleteCacheTimerId(-1),
+        _isQuiting(0)
+    {
+        _thread = new QThread();
+        moveToThread(_thread);
+        // JS scope is created in the thread that will use it
+        VERIFY(connect( _thread, SIGNAL(started()), this, SLOT(init()) ));
+        VERIFY(connect( _thread, SIGNAL(finished()), _thread, SLOT(deleteLater()) ));
+        VERIFY(connect( _thread, SIGNAL(finished()), this, SLOT(deleteLater()) ));
+        _thread->start();
+    }
+
+    ScriptWorker::~ScriptWorker()
+    {
+        if (_timerId != -1)
+            killTimer(_timerId);
+
+        if (_dbAutocompleteCacheTimerId != -1)
+            killTimer(_dbAutocompleteCacheTimerId);
+
+        delete _scriptEngine;
+        delete _connection;
+
+        // QThread "_thread" and ScriptWorker itself will be deleted later
+        // (see ScriptWorker() constructor)
+    }
+
+    void ScriptWorker::init()
+    {
+        try {
+            _scriptEngine = new ScriptEngine(_connection, _shellTimeoutSec);
+            _scriptEngine->init(_isLoadMongoRcJs);
+            _scriptEngine->use(_connection->defaultDatabase());
+            _scriptEngine->setBatchSize(_batchSize);
+            _timerId = startTimer(pingTimeMs);
+            _dbAutocompleteCacheTimerId = startTimer(dbAutocompleteCacheTimeMs);
+        } catch (const std::exception &ex) {
+            LOG_MSG(ex.what(), mongo::logger::LogSeverity::Error());
+        }
+    }
+
+    void ScriptWorker::timerEvent(QTimerEvent *event)
+    {
+        if (!_scriptEngine)
+            return;
+
+        try {
+            if (_timerId == event->timerId()) {
+                _scriptEngine->ping();
+                return;
+            }
+
+            if (_dbAutocompleteCacheTimerId == event->timerId()) {
+                _scriptEngine->invalidateDbCollectionsCache();
+                return;
+            }
+        } catch(std::exception &ex) {
+            LOG_MSG(ex.what(), mongo::logger::LogSeverity::Error());
+        }
+    }
+
+    void ScriptWorker::interrupt()
+    {
+        try {
+            if (_isQuiting || !_scriptEngine)
+                return;
+
+            _scriptEngine->interrupt();
+        } catch(const mongo::DBException &ex) {
+            LOG_MSG(ex.what(), mongo::logger::LogSeverity::Error());
+        }
+    }
+
+    void ScriptWorker::stop()
+    {
+        // Running script is interrupted, its result is not sent
+        interrupt();
+        _isQuiting = 1;
+    }
+
+    void ScriptWorker::stopAndDelete()
+    {
+        _isQuiting = 1;
+        _thread->quit();
+    }
+
+    void ScriptWorker::handle(ExecuteScriptRequest *event)
+    {
+        try {
+            if (!_scriptEngine) {
+                reply(event->sender(), new ExecuteScriptResponse(this, EventError("MongoDB Shell was not initialized")));
+                return;
+            }
+
+            MongoShellExecResult result = _scriptEngine->exec(event->script, event->databaseName);
+            reply(event->sender(), new ExecuteScriptResponse(this, result, event->script.empty()));
+        } catch(const mongo::DBException &ex) {
+            reply(event->sender(), new ExecuteScriptResponse(this, EventError(ex.what())));
+            LOG_MSG(ex.what(), mongo::logger::LogSeverity::Error());
+        }
+    }
+
+    void ScriptWorker::handle(AutocompleteRequest *event)
+    {
+        try {
+            if (!_scriptEngine) {
+                reply(event->sender(), new AutocompleteResponse(this, EventError("MongoDB Shell was not initialized")));
+                return;
+            }
+
+            QStringList list = _scriptEngine->complete(event->prefix, event->mode);
+            reply(event->sender(), new AutocompleteResponse(this, list, event->prefix));
+        } catch(const mongo::DBException &ex) {
+            reply(event->sender(), new AutocompleteResponse(this, EventError(ex.what())));
+            LOG_MSG(ex.what(), mongo::logger::LogSeverity::Error());
+        }
+    }
+
+    void ScriptWorker::reply(QObject *receiver, Event *event)
+    {
+        if (_isQuiting)
+            return;
+
+        AppRegistry::instance().bus()->send(receiver, event);
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QObject>
+
+#include "robomongo/core/events/MongoEvents.h"
+
+QT_BEGIN_NAMESPACE
+class QThread;
+QT_END_NAMESPACE
+
+namespace Robomongo
+{
+    class ScriptEngine;
+    class ConnectionSettings;
+
+    /**
+     * @brief Runs MongoDB shell (JavaScript scope) of one connection.
+     *        Script may block for a long time and JS scope is bound to the
+     *        thread that created it, so ScriptWorker has its own dedicated
+     *        thread, while MongoWorkers share threads of WorkerThreadPool.
+     *
+     *        ScriptWorker is created by MongoWorker on the first
+     *        ExecuteScriptRequest or AutocompleteRequest and is owned by it.
+     */
+    class ScriptWorker : public QObject
+    {
+        Q_OBJECT
+
+    public:
+        /**
+         * @param connection: ScriptWorker takes ownership of this settings.
+         */
+        ScriptWorker(ConnectionSettings *connection, bool isLoadMongoRcJs, int batchSize, int shellTimeoutSec);
+        ~ScriptWorker();
+        enum { pingTimeMs = 60 * 1000, dbAutocompleteCacheTimeMs = 30 * 1000 };
+        void interrupt();
+        /**
+         * @brief Stops replying to senders of requests, may be called from any thread
+         */
+        void stop();
+        void stopAndDelete();
+
+    protected Q_SLOTS: // handlers:
+        void init();
+
+        /**
+         * @brief Execute javascript
+         */
+        void handle(ExecuteScriptRequest *event);
+        void handle(AutocompleteRequest *event);
+
+    protected:
+        virtual void timerEvent(QTimerEvent *);
+
+    private:
+        /**
+         * @brief Send reply event to object 'receiver'
+         */
+        void reply(QObject *receiver, Event *event);
+
+        QThread *_thread;
+        ScriptEngine *_scriptEngine;
+        ConnectionSettings *_connection;
+
+        const bool _isLoadMongoRcJs;
+        const int _batchSize;
+        const int _shellTimeoutSec;
+        int _timerId;
+        int _dbAutocompleteCacheTimerId;
+        QAtomicInteger<int> _isQuiting;
+    };
+}
@@ -0,0 +1,70 @@
+#include "robomongo/core/mongodb/WorkerThreadPool.h"
+
+#include <QThread>
+
+namespace Robomongo
+{
+    WorkerThreadPool::WorkerThreadPool(int maxThreadCount /* = 0 */) :
+        _maxThreadCount(maxThreadCount)
+    {
+        if (_maxThreadCount <= 0)
+            _maxThreadCount = QThread::idealThreadCount();
+
+        // idealThreadCount() returns -1 if number of cores cannot be detected
+        if (_maxThreadCount < 2)
+            _maxThreadCount = 2;
+    }
+
+    WorkerThreadPool::~WorkerThreadPool()
+    {
+        ThreadsContainerType threads;
+        {
+            QMutexLocker lock(&_lock);
+            threads.swap(_threads);
+        }
+
+        // Workers that are still alive are deleted when their thread finishes,
+        // and they call release() from that thread, so lock is not held here
+        for (ThreadsContainerType::iterator it = threads.begin(); it != threads.end(); ++it) {
+            QThread *thread = it->first;
+            thread->quit();
+            thread->wait();
+            delete thread;
+        }
+    }
+
+    QThread *WorkerThreadPool::acquire()
+    {
+        QMutexLocker lock(&_lock);
+
+        ThreadsContainerType::iterator leastLoaded = _threads.end();
+        for (ThreadsContainerType::iterator it = _threads.begin(); it != _threads.end(); ++it) {
+            if (leastLoaded == _threads.end() || it->second < leastLoaded->second)
+                leastLoaded = it;
+        }
+
+        bool hasFreeThread = leastLoaded != _threads.end() && leastLoaded->second == 0;
+        bool isFull = leastLoaded == _threads.end() || leastLoaded->second >= maxWorkersPerThread;
+        if (isFull || (!hasFreeThread && static_cast<int>(_threads.size()) < _maxThreadCount)) {
+            QThread *thread = new QThread();
+            thread->start();
+            _threads.push_back(ThreadLoadType(thread, 1));
+            return thread;
+        }
+
+        leastLoaded->second++;
+        return leastLoaded->first;
+    }
+
+    void WorkerThreadPool::release(QThread *thread)
+    {
+        QMutexLocker lock(&_lock);
+
+        for (ThreadsContainerType::iterator it = _threads.begin(); it != _threads.end(); ++it) {
+            if (it->first == thread) {
+                it->second--;
+                return;
+            }
+        }
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vector>
+#include <QMutex>
+
+QT_BEGIN_NAMESPACE
+class QThread;
+QT_END_NAMESPACE
+
+namespace Robomongo
+{
+    /**
+     * @brief Fixed set of threads with event loops, shared by all MongoWorkers.
+     *        Worker is moved to one of these threads and its events are
+     *        processed in order by that thread, so every worker still has
+     *        its own serial queue. Number of threads does not grow with
+     *        number of opened tabs and connections.
+     *
+     *        Workers do blocking network I/O in their event handlers, so a slow
+     *        request of one worker delays events of other workers on the same
+     *        thread. This head-of-line blocking is bounded: thread is shared by
+     *        at most maxWorkersPerThread workers (extra threads are started when
+     *        all threads are full), and every request is limited by the socket
+     *        timeout of connection. Requests that may run for minutes (scripts,
+     *        copying of collections, statistics) are not handled on these threads.
+     *
+     *        You can access this pool via:
+     *        AppRegistry::instance().workerThreadPool()
+     *
+     * @threadsafe yes
+     */
+    class WorkerThreadPool
+    {
+    public:
+        /**
+         * @brief Maximum number of workers, that are handled by one thread
+         */
+        enum { maxWorkersPerThread = 4 };
+
+        /**
+         * @brief Creates pool, that starts up to 'maxThreadCount' threads before
+         *        workers share them. If not positive, number of CPU cores is used.
+         */
+        explicit WorkerThreadPool(int maxThreadCount = 0);
+
+        /**
+         * @brief Stops all threads
+         */
+        ~WorkerThreadPool();
+
+        /**
+         * @brief Returns the least loaded thread. New thread is started when all
+         *        existing threads are in use and there are less than 'maxThreadCount'
+         *        threads, or when all threads have maxWorkersPerThread workers.
+         */
+        QThread *acquire();
+
+        /**
+         * @brief Worker that was using 'thread' is deleted
+         */
+        void release(QThread *thread);
+
+    private:
+        typedef std::pair<QThread *, int> ThreadLoadType; // thread and number of workers
+        typedef std::vector<ThreadLoadType> ThreadsContainerType;
+
+        ThreadsContainerType _threads;
+        int _maxThreadCount;
+        QMutex _lock;
+    };
+}
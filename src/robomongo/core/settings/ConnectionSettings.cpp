@@ -14,6 +14,8 @@ namespace
     const char *defaultNameConnection = "New Connection";
 
     const int maxLength = 300;
+    const int defaultMaxPoolSize = 10;
+    const char *defaultWriteConcernW = "1";
 }
 
 namespace Robomongo
@@ -26,6 +28,10 @@ namespace Robomongo
         _connectionName(defaultNameConnection),
         _host(defaultServerHost),
         _port(port),
+        _maxPoolSize(defaultMaxPoolSize),
+        _writeConcernW(defaultWriteConcernW),
+        _writeConcernJournal(false),
+        _writeConcernTimeoutMs(0),
         _imported(false),
         _sshSettings(new SshSettings()),
         _sslSettings(new SslSettings()) { }
@@ -36,6 +42,17 @@ namespace Robomongo
         setServerPort(map.value("serverPort").toInt());
         setDefaultDatabase(QtUtils::toStdString(map.value("defaultDatabase").toString()));
 
+        if (map.contains("maxPoolSize")) {
+            setMaxPoolSize(map.value("maxPoolSize").toInt());
+        }
+
+        if (map.contains("writeConcern")) {
+            QVariantMap writeConcernMap = map.value("writeConcern").toMap();
+            setWriteConcernW(QtUtils::toStdString(writeConcernMap.value("w", defaultWriteConcernW).toString()));
+            setWriteConcernJournal(writeConcernMap.value("j").toBool());
+            setWriteConcernTimeoutMs(writeConcernMap.value("wtimeout").toInt());
+        }
+
         QVariantList list = map.value("credentials").toList();
         for (QVariantList::const_iterator it = list.begin(); it != list.end(); ++it) {
             QVariant var = *it;
@@ -85,6 +102,10 @@ namespace Robomongo
         setServerHost(source->serverHost());
         setServerPort(source->serverPort());
         setDefaultDatabase(source->defaultDatabase());
+        setMaxPoolSize(source->maxPoolSize());
+        setWriteConcernW(source->writeConcernW());
+        setWriteConcernJournal(source->writeConcernJournal());
+        setWriteConcernTimeoutMs(source->writeConcernTimeoutMs());
         setImported(source->imported());
 
         clearCredentials();
@@ -112,6 +133,13 @@ namespace Robomongo
         map.insert("serverHost", QtUtils::toQString(serverHost()));
         map.insert("serverPort", serverPort());
         map.insert("defaultDatabase", QtUtils::toQString(defaultDatabase()));
+        map.insert("maxPoolSize", maxPoolSize());
+
+        QVariantMap writeConcernMap;
+        writeConcernMap.insert("w", QtUtils::toQString(writeConcernW()));
+        writeConcernMap.insert("j", writeConcernJournal());
+        writeConcernMap.insert("wtimeout", writeConcernTimeoutMs());
+        map.insert("writeConcern", writeConcernMap);
 #ifdef MONGO_SSL
         SSLInfo infl = _info.sslInfo();
         map.insert("sslEnabled", infl._sslSupport);
@@ -185,6 +213,27 @@ namespace Robomongo
         _credentials.clear();
     }
 
+    mongo::BSONObj ConnectionSettings::writeConcern() const
+    {
+        mongo::BSONObjBuilder builder;
+
+        // Number of members is sent as number, tag set name as string
+        bool isNumber = false;
+        int w = QtUtils::toQString(_writeConcernW).toInt(&isNumber);
+        if (isNumber)
+            builder.append("w", w);
+        else if (!_writeConcernW.empty())
+            builder.append("w", _writeConcernW);
+
+        if (_writeConcernJournal)
+            builder.append("j", true);
+
+        if (_writeConcernTimeoutMs > 0)
+            builder.append("wtimeout", _writeConcernTimeoutMs);
+
+        return builder.obj();
+    }
+
     std::string ConnectionSettings::getFullAddress() const
     {
         return info().toString();
@@ -72,6 +72,29 @@ namespace Robomongo
         std::string defaultDatabase() const { return _defaultDatabase; }
         void setDefaultDatabase(const std::string &defaultDatabase) { _defaultDatabase = defaultDatabase; }
 
+        /**
+         * @brief Maximum number of connections (borrowed and idle) in pool for this server
+         */
+        int maxPoolSize() const { return _maxPoolSize; }
+        void setMaxPoolSize(int maxPoolSize) { _maxPoolSize = maxPoolSize; }
+
+        /**
+         * @brief Write concern of insert, update and delete commands:
+         * number of members ("0", "1", "2", ...) or tag set name ("majority"),
+         * journal acknowledgement and timeout in milliseconds (0 - no timeout).
+         */
+        std::string writeConcernW() const { return _writeConcernW; }
+        void setWriteConcernW(const std::string &w) { _writeConcernW = w; }
+        bool writeConcernJournal() const { return _writeConcernJournal; }
+        void setWriteConcernJournal(bool journal) { _writeConcernJournal = journal; }
+        int writeConcernTimeoutMs() const { return _writeConcernTimeoutMs; }
+        void setWriteConcernTimeoutMs(int timeoutMs) { _writeConcernTimeoutMs = timeoutMs; }
+
+        /**
+         * @brief Returns { w: <w>, j: <bool>, wtimeout: <ms> } document for write commands
+         */
+        mongo::BSONObj writeConcern() const;
+
         /**
          * Was this connection imported from somewhere?
          */
@@ -159,6 +182,10 @@ namespace Robomongo
         std::string _host;
         int _port;
         std::string _defaultDatabase;
+        int _maxPoolSize;
+        std::string _writeConcernW;
+        bool _writeConcernJournal;
+        int _writeConcernTimeoutMs;
         QList<CredentialSettings *> _credentials;
         SshSettings *_sshSettings;
         SslSettings *_sslSettings;
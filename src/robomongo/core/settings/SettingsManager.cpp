@@ -119,6 +119,11 @@ namespace Robomongo
         return ok;
     }
 
+    QString SettingsManager::configDir() const
+    {
+        return _configDir;
+    }
+
     /**
      * Load settings from the map. Existings settings will be overwritten.
      */
@@ -46,6 +46,11 @@ namespace Robomongo
          */
         bool save();
 
+        /**
+         * @brief Directory of config file (usually ~/.config/robomongo/0.9)
+         */
+        QString configDir() const;
+
         /**
          * @brief Adds connection to the end of list.
          * Connection now will be owned by SettingsManager.
@@ -3,8 +3,9 @@
 #include <mongo/client/dbclientinterface.h>
 //#include <mongo/bson/bsonobjiterator.h>
 #include "robomongo/core/utils/QtUtils.h"
+#include "robomongo/core/utils/JsonWriter.h"
+#include "robomongo/core/utils/FormatUtils.h"
 #include "robomongo/core/HexUtils.h"
-#include "mongo/util/base64.h"
 
 // v0.9
 #include "robomongo/shell/db/ptimeutil.h"
@@ -61,298 +62,16 @@ namespace Robomongo
 
         std::string jsonString(const BSONObj &obj, JsonStringFormat format, int pretty, UUIDEncoding uuidEncoding, SupportedTimes timeFormat, bool isArray)
         {
-            using namespace std;
-
-            // Use of method, that is implemented in Robomongo Shell
-            // Method "isArray()" is not part of MongoDB.
-            // In order for this method to work, someone should
-            // explicetly call "markAsArray()" method on BSONObj.
-            // This is done in the Robomongo Shell (MongoDB fork)
-            if (obj.isArray()) {
-               isArray = true;
-            }
-
-            if ( obj.isEmpty() ) {
-                return isArray? "[]" : "{}";
-            }
-
-            StringBuilder s;
-            s << (isArray ? "[" : "{");
-            BSONObjIterator i(obj);
-            BSONElement e = i.next();
-            if ( !e.eoo() ) {
-                while ( 1 ) {
-                    if ( pretty ) {
-                        s << '\n';
-                        for( int x = 0; x < pretty; x++ ) {
-                            s << "    ";
-                        }
-                    }
-                    else {
-                        s << " ";
-                    }
-                    s << jsonString(e, format, true, pretty ? pretty + 1 : 0, uuidEncoding, timeFormat, isArray);
-                    e = i.next();
-
-                    if (e.eoo()) {
-                        s << '\n';
-                        for( int x = 0; x < pretty - 1; x++ ) {
-                            s << "    ";
-                        }
-                        s << (isArray ? "]" : "}");
-                        break;
-                    }
-
-                    s << ",";
-                }
-            }
-            return s.str();
+            std::string result;
+            JsonWriter(result, format, uuidEncoding, timeFormat).writeObject(obj, pretty, isArray);
+            return result;
         }
 
         std::string jsonString(const BSONElement &elem, JsonStringFormat format, bool includeFieldNames, int pretty, UUIDEncoding uuidEncoding, SupportedTimes timeFormat, bool isArray)
         {
-            using namespace std;
-            BSONType t = elem.type();            
-
-            std::stringstream s;
-            if ( includeFieldNames && !isArray)
-                s << '"' << escape( elem.fieldName() ) << "\" : ";
-
-            switch ( t ) {
-            case Undefined:
-                s << "undefined";
-                break;
-            case mongo::String:
-            case Symbol:
-                s << '"' << escape( std::string(elem.valuestr(), elem.valuestrsize()-1) ) << '"';
-                break;
-            case NumberLong:
-                s << "NumberLong(" << elem._numberLong() << ")";
-                break;
-            case NumberInt:
-                s << elem._numberInt();
-                break;
-            case NumberDouble:
-                {
-                    int sign = 0;
-                    if ( elem.number() >= -std::numeric_limits< double >::max() &&
-                            elem.number() <= std::numeric_limits< double >::max() ) {
-
-                        // was 16
-                        s.precision(std::numeric_limits<double>::digits10);
-                        s << elem.number();
-
-                        // Leave trailing zero if needed
-                        if (elem.number() == (long long)elem.number())
-                            s << ".0";
-                    }
-                    else if (std::isnan(elem.number()) ) {
-                        s << "NaN";
-                    }
-                    else if (std::isinf(elem.number()) ) {
-                        s << "Infinity";
-//                        s << ( sign == 1 ? "Infinity" : "-Infinity");
-                    }
-                    else {
-                        StringBuilder ss;
-                        ss << "Number " << elem.number() << " cannot be represented in JSON";
-                        string message = ss.str();
-                        //massert( 10311 ,  message.c_str(), false );
-                    }
-                    break;
-                }
-            case NumberDecimal:
-                s << "NumberDecimal(" << elem._numberDecimal().toString() << ")";
-                break;
-            case mongo::Bool:
-                s << ( elem.boolean() ? "true" : "false" );
-                break;
-            case jstNULL:
-                s << "null";
-                break;
-            case Object: {
-                BSONObj obj = elem.embeddedObject();
-                s << jsonString(obj, format, pretty, uuidEncoding, timeFormat);
-                }
-                break;
-            case mongo::Array: {
-                if ( elem.embeddedObject().isEmpty() ) {
-                    s << "[]";
-                    break;
-                }
-                s << "[ ";
-                BSONObjIterator i( elem.embeddedObject() );
-                BSONElement e = i.next();
-                if ( !e.eoo() ) {
-                    int count = 0;
-                    while ( 1 ) {
-                        if ( pretty ) {
-                            s << '\n';
-                            for( int x = 0; x < pretty; x++ )
-                                s << "    ";
-                        }
-
-                        if (strtol(e.fieldName(), 0, 10) > count) {
-                            s << "undefined";
-                        }
-                        else {
-                            s << jsonString(e, format, false, pretty ? pretty + 1 : 0, uuidEncoding, timeFormat, true);
-                            e = i.next();
-                        }
-                        count++;
-                        if ( e.eoo() ) {
-                            s << '\n';
-                            for( int x = 0; x < pretty - 1; x++ )
-                                s << "    ";
-                            s << "]";
-                            break;
-                        }
-                        s << ", ";
-                    }
-                }
-                //s << " ]";
-                break;
-            }
-            case DBRef: {
-                mongo::OID *x = (mongo::OID *) (elem.valuestr() + elem.valuestrsize());
-                if ( format == TenGen )
-                    s << "DBRef(";
-                else
-                    s << "{ \"$ref\" : ";
-                s << '"' << elem.valuestr() << "\", ";
-                if ( format != TenGen )
-                    s << "\"$id\" : ";
-                s << '"' << *x << "\"";
-                if ( format == TenGen )
-                    s << ')';
-                else
-                    s << '}';
-                break;
-            }
-            case jstOID:
-                if ( format == TenGen ) {
-                    s << "ObjectId(";
-                }
-                else {
-                    s << "{ \"$oid\" : ";
-                }
-                s << '"' << elem.__oid() << '"';
-                if ( format == TenGen ) {
-                    s << ")";
-                }
-                else {
-                    s << " }";
-                }
-                break;
-            case BinData: {
-                int len = *(int *)( elem.value() );
-                BinDataType type = BinDataType( *(char *)( (int *)( elem.value() ) + 1 ) );
-
-                if (type == mongo::bdtUUID || type == mongo::newUUID) {
-                    s << HexUtils::formatUuid(elem, uuidEncoding);
-                    break;
-                }
-
-                s << "{ \"$binary\" : \"";
-                char *start = ( char * )( elem.value() ) + sizeof( int ) + 1;
-                base64::encode( s , start , len );
-                s << "\", \"$type\" : \"" << hex;
-                s.width( 2 );
-                s.fill( '0' );
-                s << type << dec;
-                s << "\" }";
-                break;
-            }
-            case mongo::Date:
-                {
-                    Date_t d = elem.date();
-                    long long ms = d.toMillisSinceEpoch(); //static_cast<long long>(d.millis);
-                    bool isSupportedDate = miutil::minDate < ms && ms < miutil::maxDate;
-
-                    if ( format == Strict )
-                        s << "{ \"$date\" : ";
-                    else{
-                        if (isSupportedDate) {
-                            s << "ISODate(";
-                        }
-                        else{
-                            s << "Date(";
-                        }
-                    }
-
-                    if ( pretty && isSupportedDate) {
-                        boost::posix_time::ptime epoch(boost::gregorian::date(1970, 1, 1));
-                        boost::posix_time::time_duration diff = boost::posix_time::millisec(ms);
-                        boost::posix_time::ptime time = epoch + diff;
-                        std::string timestr = miutil::isotimeString(time, true, timeFormat == LocalTime);
-                        s << '"' << timestr << '"';
-                    }
-                    else
-                        s << ms;
-
-                    if ( format == Strict )
-                        s << " }";
-                    else
-                        s << ")";
-                    break;
-                }
-            case RegEx:
-                if ( format == Strict ) {
-                    s << "{ \"$regex\" : \"" << escape( elem.regex() );
-                    s << "\", \"$options\" : \"" << elem.regexFlags() << "\" }";
-                }
-                else {
-                    s << "/" << escape( elem.regex() , true ) << "/";
-                    // FIXME Worry about alpha order?
-                    for ( const char *f = elem.regexFlags(); *f; ++f ) {
-                        switch ( *f ) {
-                        case 'g':
-                        case 'i':
-                        case 'm':
-                            s << *f;
-                        default:
-                            break;
-                        }
-                    }
-                }
-                break;
-
-            case CodeWScope: {
-                BSONObj scope = elem.codeWScopeObject();
-                if ( ! scope.isEmpty() ) {
-                    s << "{ \"$code\" : " << elem._asCode() << " , "
-                      << " \"$scope\" : " << scope.jsonString() << " }";
-                    break;
-                }
-            }
-
-            case Code:
-                s << elem._asCode();
-                break;
-
-            case bsonTimestamp:
-                if ( format == TenGen ) {
-                    s << "Timestamp(" << ( elem.timestampValue() / 1000 ) << ", " << elem.timestampInc() << ")";
-                }
-                else {
-                    s << "{ \"$timestamp\" : { \"t\" : " << ( elem.timestampValue() / 1000 ) << ", \"i\" : " << elem.timestampInc() << " } }";
-                }
-                break;
-
-            case MinKey:
-                s << "{ \"$minKey\" : 1 }";
-                break;
-
-            case MaxKey:
-                s << "{ \"$maxKey\" : 1 }";
-                break;
-
-            default:
-                StringBuilder ss;
-                ss << "Cannot create a properly formatted JSON string with "
-                   << "element: " << elem.toString() << " of type: " << elem.type();
-            }
-            return s.str();
+            std::string result;
+            JsonWriter(result, format, uuidEncoding, timeFormat).writeElement(elem, includeFieldNames, pretty, isArray);
+            return result;
         }
     
         bool isArray(const mongo::BSONElement &elem)
@@ -581,15 +300,11 @@ namespace Robomongo
             {
             case NumberDouble:
                 {
-                    std::stringstream s;
-                    s.precision(std::numeric_limits<double>::digits10);
-                    s << elem.Double();
+                    FormatUtils::appendDouble(con, elem.Double());
 
                     // Leave trailing zero if needed
                     if (elem.Double() == (long long)elem.Double())
-                        s << ".0";
-
-                    con.append(s.str());
+                        con.append(".0");
                 }
                 break;
             case String:
@@ -637,17 +352,18 @@ namespace Robomongo
                     long long ms = (long long) elem.Date().toMillisSinceEpoch();
                     bool isSupportedDate = miutil::minDate < ms && ms < miutil::maxDate;
 
-                    boost::posix_time::ptime epoch(boost::gregorian::date(1970, 1, 1));
-                    boost::posix_time::time_duration diff = boost::posix_time::millisec(ms);
-                    boost::posix_time::ptime time = epoch + diff;
-
-                    std::string date;
-                    if (isSupportedDate)
-                        date = miutil::isotimeString(time, false, tz == LocalTime);
-                    else
-                        date = boost::lexical_cast<std::string>(ms);
-
-                    con.append(date);
+                    if (!isSupportedDate) {
+                        FormatUtils::appendInt(con, ms);
+                    }
+                    else if (tz == Utc) {
+                        FormatUtils::appendIsoDate(con, ms, false);
+                    }
+                    else {
+                        boost::posix_time::ptime epoch(boost::gregorian::date(1970, 1, 1));
+                        boost::posix_time::time_duration diff = boost::posix_time::millisec(ms);
+                        boost::posix_time::ptime time = epoch + diff;
+                        con.append(miutil::isotimeString(time, false, true));
+                    }
                     break;
                 }
             case jstNULL:
@@ -688,12 +404,8 @@ namespace Robomongo
                 }
                 break;
             case NumberInt:
-                {
-                    char num[16] = {0};
-                    sprintf(num, "%d", elem.Int());
-                    con.append(num);
-                    break;
-                }           
+                FormatUtils::appendInt(con, elem.Int());
+                break;           
             case bsonTimestamp:
                 {
                     Date_t date = elem.timestampTime();
@@ -705,12 +417,8 @@ namespace Robomongo
                     break;
                 }
             case NumberLong:
-                {
-                    char num[32] = {0};
-                    sprintf(num, "%lld", elem.Long());
-                    con.append(num);
-                    break; 
-                }
+                FormatUtils::appendInt(con, elem.Long());
+                break;
             default:
                 con.append("<unsupported>");
                 break;
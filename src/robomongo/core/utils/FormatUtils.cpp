@@ -0,0 +1,209 @@
+#include "robomongo/core/utils/FormatUtils.h"
+
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+namespace
+{
+    const char digitPairs[] =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899";
+
+    // Powers of ten, that are exact in double
+    const double powersOf10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9,
+        1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18
+    };
+
+    const int significantDigits = std::numeric_limits<double>::digits10;    // 15
+    const unsigned long long minSignificand = 100000000000000ULL;          // 10^14
+    const unsigned long long maxSignificand = 1000000000000000ULL;         // 10^15
+
+    /**
+     * @brief Writes decimal digits of 'value' ending at 'end'
+     * @return pointer to the first digit
+     */
+    char *writeDigits(char *end, unsigned long long value)
+    {
+        char *p = end;
+        while (value >= 100) {
+            unsigned index = static_cast<unsigned>(value % 100) * 2;
+            value /= 100;
+            *--p = digitPairs[index + 1];
+            *--p = digitPairs[index];
+        }
+
+        if (value >= 10) {
+            unsigned index = static_cast<unsigned>(value) * 2;
+            *--p = digitPairs[index + 1];
+            *--p = digitPairs[index];
+        }
+        else {
+            *--p = static_cast<char>('0' + value);
+        }
+
+        return p;
+    }
+
+    void appendTwoDigits(std::string &output, int value)
+    {
+        output.append(digitPairs + value * 2, 2);
+    }
+
+    void appendDoubleStreamed(std::string &output, double value)
+    {
+        std::stringstream s;
+        s.precision(significantDigits);
+        s << value;
+        output.append(s.str());
+    }
+
+    /**
+     * @brief Formats 'value' with 15 significant digits in fixed notation,
+     * as "%.15g" does for decimal exponents from -4 to 14.
+     * @return false, if value needs exponential notation, or if rounding
+     * of product can differ from exact rounding of 'value'
+     */
+    bool appendDoubleFixed(std::string &output, double value)
+    {
+        const double absValue = std::fabs(value);
+        if (!(absValue >= 1e-4 && absValue < 1e15))
+            return false;
+
+        int exponent = static_cast<int>(std::floor(std::log10(absValue)));
+        if (exponent < -4 || exponent > 14)
+            return false;
+
+        // Product is exact up to rounding to double, its error is at most
+        // half of ulp, which is 1/16 for numbers below 2^50 (> 10^15)
+        const double scaled = absValue * powersOf10[significantDigits - 1 - exponent];
+        if (scaled < static_cast<double>(minSignificand) || scaled >= static_cast<double>(maxSignificand))
+            return false;
+
+        const double whole = std::floor(scaled);
+        const double fraction = scaled - whole;
+        if (std::fabs(fraction - 0.5) <= 0.0625)
+            return false;
+
+        unsigned long long significand = static_cast<unsigned long long>(whole) + (fraction > 0.5 ? 1 : 0);
+        if (significand >= maxSignificand)
+            return false;
+
+        char digits[significantDigits];
+        writeDigits(digits + significantDigits, significand);
+
+        // Trailing zeros are not written
+        int last = significantDigits - 1;
+        while (last > 0 && digits[last] == '0')
+            --last;
+
+        if (value < 0)
+            output += '-';
+
+        if (exponent >= 0) {
+            output.append(digits, exponent + 1);
+            if (last > exponent) {
+                output += '.';
+                output.append(digits + exponent + 1, last - exponent);
+            }
+        }
+        else {
+            output.append("0.");
+            output.append(-exponent - 1, '0');
+            output.append(digits, last + 1);
+        }
+
+        return true;
+    }
+}
+
+namespace Robomongo
+{
+    namespace FormatUtils
+    {
+        void appendInt(std::string &output, long long value)
+        {
+            // Negation is done in unsigned type to support the minimum value
+            unsigned long long absValue = static_cast<unsigned long long>(value);
+            if (value < 0) {
+                output += '-';
+                absValue = 0 - absValue;
+            }
+            appendUInt(output, absValue);
+        }
+
+        void appendUInt(std::string &output, unsigned long long value)
+        {
+            char buffer[24];
+            char *end = buffer + sizeof(buffer);
+            char *begin = writeDigits(end, value);
+            output.append(begin, end - begin);
+        }
+
+        void appendDouble(std::string &output, double value)
+        {
+            if (value == 0) {
+                output.append(std::signbit(value) ? "-0" : "0");
+                return;
+            }
+
+            if (!appendDoubleFixed(output, value))
+                appendDoubleStreamed(output, value);
+        }
+
+        void appendIsoDate(std::string &output, long long millis, bool useTseparator)
+        {
+            const long long millisInDay = 86400000LL;
+            long long days = millis / millisInDay;
+            long long millisOfDay = millis % millisInDay;
+            if (millisOfDay < 0) {
+                millisOfDay += millisInDay;
+                --days;
+            }
+
+            // Civil date from number of days since 1970-01-01, in proleptic
+            // Gregorian calendar (eras of 400 years start at March, 1)
+            const long long shifted = days + 719468;
+            const long long era = (shifted >= 0 ? shifted : shifted - 146096) / 146097;
+            const int dayOfEra = static_cast<int>(shifted - era * 146097);
+            const int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+            const int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+            const int monthFromMarch = (5 * dayOfYear + 2) / 153;
+            const int day = dayOfYear - (153 * monthFromMarch + 2) / 5 + 1;
+            const int month = monthFromMarch < 10 ? monthFromMarch + 3 : monthFromMarch - 9;
+            const int year = static_cast<int>(yearOfEra + era * 400) + (month <= 2 ? 1 : 0);
+
+            const int milliseconds = static_cast<int>(millisOfDay % 1000);
+            const int seconds = static_cast<int>(millisOfDay / 1000 % 60);
+            const int minutes = static_cast<int>(millisOfDay / 60000 % 60);
+            const int hours = static_cast<int>(millisOfDay / 3600000);
+
+            // Supported dates have years of 4 digits
+            appendTwoDigits(output, year / 100);
+            appendTwoDigits(output, year % 100);
+            output += '-';
+            appendTwoDigits(output, month);
+            output += '-';
+            appendTwoDigits(output, day);
+            output += useTseparator ? 'T' : ' ';
+            appendTwoDigits(output, hours);
+            output += ':';
+            appendTwoDigits(output, minutes);
+            output += ':';
+            appendTwoDigits(output, seconds);
+            output += '.';
+            output += static_cast<char>('0' + milliseconds / 100);
+            appendTwoDigits(output, milliseconds % 100);
+            output += 'Z';
+        }
+    }
+}
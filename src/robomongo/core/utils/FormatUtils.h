@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+
+namespace Robomongo
+{
+    /**
+     * @brief Formatting of numbers and dates for rendering of BSON values.
+     *        Functions append to output buffer and do not allocate
+     *        anything except growth of the buffer.
+     *
+     *        Output is the same as of formatting used before:
+     *        std::stringstream for numbers and miutil::isotimeString()
+     *        for dates in UTC.
+     */
+    namespace FormatUtils
+    {
+        void appendInt(std::string &output, long long value);
+        void appendUInt(std::string &output, unsigned long long value);
+
+        /**
+         * @brief Appends 'value' as std::stringstream with precision
+         * of std::numeric_limits<double>::digits10 (15 significant digits,
+         * "%.15g") does. Values, that can not be formatted exactly by the
+         * fast path, are formatted by std::stringstream.
+         */
+        void appendDouble(std::string &output, double value);
+
+        /**
+         * @brief Appends date as "1970-01-01T00:00:00.000Z" in UTC.
+         * @param millis: milliseconds since epoch, in range of supported
+         *        dates (miutil::minDate, miutil::maxDate)
+         * @param useTseparator: separate date and time with 'T' instead of ' '
+         */
+        void appendIsoDate(std::string &output, long long millis, bool useTseparator);
+    }
+}
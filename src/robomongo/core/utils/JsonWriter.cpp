@@ -0,0 +1,334 @@
+#include "robomongo/core/utils/JsonWriter.h"
+
+#include <cmath>
+#include <limits>
+#include <mongo/client/dbclientinterface.h>
+#include "robomongo/core/HexUtils.h"
+#include "robomongo/core/utils/FormatUtils.h"
+#include "mongo/util/base64.h"
+
+// v0.9
+#include "robomongo/shell/db/ptimeutil.h"
+
+using namespace mongo;
+namespace Robomongo
+{
+    JsonWriter::JsonWriter(std::string &output, JsonStringFormat format,
+                           UUIDEncoding uuidEncoding, SupportedTimes timeFormat) :
+        _output(output),
+        _format(format),
+        _uuidEncoding(uuidEncoding),
+        _timeFormat(timeFormat)
+    {
+    }
+
+    void JsonWriter::writeObject(const BSONObj &obj, int pretty, bool isArray)
+    {
+        // Use of method, that is implemented in Robomongo Shell
+        // Method "isArray()" is not part of MongoDB.
+        // In order for this method to work, someone should
+        // explicetly call "markAsArray()" method on BSONObj.
+        // This is done in the Robomongo Shell (MongoDB fork)
+        if (obj.isArray()) {
+            isArray = true;
+        }
+
+        if (obj.isEmpty()) {
+            _output.append(isArray ? "[]" : "{}");
+            return;
+        }
+
+        _output += (isArray ? '[' : '{');
+        BSONObjIterator i(obj);
+        BSONElement e = i.next();
+        if (!e.eoo()) {
+            while (1) {
+                if (pretty) {
+                    _output += '\n';
+                    writeIndent(pretty);
+                }
+                else {
+                    _output += ' ';
+                }
+                writeElement(e, true, pretty ? pretty + 1 : 0, isArray);
+                e = i.next();
+
+                if (e.eoo()) {
+                    _output += '\n';
+                    writeIndent(pretty - 1);
+                    _output += (isArray ? ']' : '}');
+                    break;
+                }
+
+                _output += ',';
+            }
+        }
+    }
+
+    void JsonWriter::writeArray(const BSONObj &arr, int pretty)
+    {
+        if (arr.isEmpty()) {
+            _output.append("[]");
+            return;
+        }
+
+        _output.append("[ ");
+        BSONObjIterator i(arr);
+        BSONElement e = i.next();
+        if (!e.eoo()) {
+            int count = 0;
+            while (1) {
+                if (pretty) {
+                    _output += '\n';
+                    writeIndent(pretty);
+                }
+
+                if (strtol(e.fieldName(), 0, 10) > count) {
+                    _output.append("undefined");
+                }
+                else {
+                    writeElement(e, false, pretty ? pretty + 1 : 0, true);
+                    e = i.next();
+                }
+                count++;
+                if (e.eoo()) {
+                    _output += '\n';
+                    writeIndent(pretty - 1);
+                    _output += ']';
+                    break;
+                }
+                _output.append(", ");
+            }
+        }
+    }
+
+    void JsonWriter::writeIndent(int level)
+    {
+        if (level <= 0)
+            return;
+
+        const size_t size = level * 4;
+        if (_indent.size() < size)
+            _indent.resize(size, ' ');
+
+        _output.append(_indent, 0, size);
+    }
+
+    void JsonWriter::writeElement(const BSONElement &elem, bool includeFieldNames, int pretty, bool isArray)
+    {
+        if (includeFieldNames && !isArray) {
+            _output += '"';
+            _output.append(escape(elem.fieldName()));
+            _output.append("\" : ");
+        }
+
+        switch (elem.type()) {
+        case Undefined:
+            _output.append("undefined");
+            break;
+        case mongo::String:
+        case Symbol:
+            _output += '"';
+            _output.append(escape(std::string(elem.valuestr(), elem.valuestrsize() - 1)));
+            _output += '"';
+            break;
+        case NumberLong:
+            _output.append("NumberLong(");
+            FormatUtils::appendInt(_output, elem._numberLong());
+            _output += ')';
+            break;
+        case NumberInt:
+            FormatUtils::appendInt(_output, elem._numberInt());
+            break;
+        case NumberDouble:
+            writeDouble(elem.number());
+            break;
+        case NumberDecimal:
+            _output.append("NumberDecimal(");
+            _output.append(elem._numberDecimal().toString());
+            _output += ')';
+            break;
+        case mongo::Bool:
+            _output.append(elem.boolean() ? "true" : "false");
+            break;
+        case jstNULL:
+            _output.append("null");
+            break;
+        case Object:
+            writeObject(elem.embeddedObject(), pretty);
+            break;
+        case mongo::Array:
+            writeArray(elem.embeddedObject(), pretty);
+            break;
+        case DBRef: {
+            mongo::OID *x = (mongo::OID *) (elem.valuestr() + elem.valuestrsize());
+            if (_format == TenGen)
+                _output.append("DBRef(");
+            else
+                _output.append("{ \"$ref\" : ");
+            _output += '"';
+            _output.append(elem.valuestr());
+            _output.append("\", ");
+            if (_format != TenGen)
+                _output.append("\"$id\" : ");
+            _output += '"';
+            _output.append(x->toString());
+            _output += '"';
+            _output += (_format == TenGen ? ')' : '}');
+            break;
+        }
+        case jstOID:
+            _output.append(_format == TenGen ? "ObjectId(\"" : "{ \"$oid\" : \"");
+            _output.append(elem.__oid().toString());
+            _output.append(_format == TenGen ? "\")" : "\" }");
+            break;
+        case BinData:
+            writeBinData(elem);
+            break;
+        case mongo::Date:
+            writeDate(elem, pretty);
+            break;
+        case RegEx:
+            if (_format == Strict) {
+                _output.append("{ \"$regex\" : \"");
+                _output.append(escape(elem.regex()));
+                _output.append("\", \"$options\" : \"");
+                _output.append(elem.regexFlags());
+                _output.append("\" }");
+            }
+            else {
+                _output += '/';
+                _output.append(escape(elem.regex(), true));
+                _output += '/';
+                // FIXME Worry about alpha order?
+                for (const char *f = elem.regexFlags(); *f; ++f) {
+                    switch (*f) {
+                    case 'g':
+                    case 'i':
+                    case 'm':
+                        _output += *f;
+                    default:
+                        break;
+                    }
+                }
+            }
+            break;
+
+        case CodeWScope: {
+            BSONObj scope = elem.codeWScopeObject();
+            if (!scope.isEmpty()) {
+                _output.append("{ \"$code\" : ");
+                _output.append(elem._asCode());
+                _output.append(" ,  \"$scope\" : ");
+                _output.append(scope.jsonString());
+                _output.append(" }");
+                break;
+            }
+        }
+
+        case Code:
+            _output.append(elem._asCode());
+            break;
+
+        case bsonTimestamp:
+            _output.append(_format == TenGen ? "Timestamp(" : "{ \"$timestamp\" : { \"t\" : ");
+            FormatUtils::appendUInt(_output, elem.timestampValue() / 1000);
+            _output.append(_format == TenGen ? ", " : ", \"i\" : ");
+            FormatUtils::appendUInt(_output, elem.timestampInc());
+            _output.append(_format == TenGen ? ")" : " } }");
+            break;
+
+        case MinKey:
+            _output.append("{ \"$minKey\" : 1 }");
+            break;
+
+        case MaxKey:
+            _output.append("{ \"$maxKey\" : 1 }");
+            break;
+
+        default:
+            // Elements of unknown types are not written
+            break;
+        }
+    }
+
+    void JsonWriter::writeDouble(double value)
+    {
+        if (value >= -std::numeric_limits<double>::max() &&
+            value <= std::numeric_limits<double>::max()) {
+            FormatUtils::appendDouble(_output, value);
+
+            // Leave trailing zero if needed
+            if (value == (long long)value)
+                _output.append(".0");
+        }
+        else if (std::isnan(value)) {
+            _output.append("NaN");
+        }
+        else if (std::isinf(value)) {
+            _output.append("Infinity");
+        }
+    }
+
+    void JsonWriter::writeDate(const BSONElement &elem, int pretty)
+    {
+        Date_t d = elem.date();
+        long long ms = d.toMillisSinceEpoch();
+        bool isSupportedDate = miutil::minDate < ms && ms < miutil::maxDate;
+
+        if (_format == Strict)
+            _output.append("{ \"$date\" : ");
+        else
+            _output.append(isSupportedDate ? "ISODate(" : "Date(");
+
+        if (pretty && isSupportedDate && _timeFormat == Utc) {
+            _output += '"';
+            FormatUtils::appendIsoDate(_output, ms, true);
+            _output += '"';
+        }
+        else if (pretty && isSupportedDate) {
+            boost::posix_time::ptime epoch(boost::gregorian::date(1970, 1, 1));
+            boost::posix_time::time_duration diff = boost::posix_time::millisec(ms);
+            boost::posix_time::ptime time = epoch + diff;
+            _output += '"';
+            _output.append(miutil::isotimeString(time, true, _timeFormat == LocalTime));
+            _output += '"';
+        }
+        else {
+            FormatUtils::appendInt(_output, ms);
+        }
+
+        _output.append(_format == Strict ? " }" : ")");
+    }
+
+    void JsonWriter::writeBinData(const BSONElement &elem)
+    {
+        int len = *(int *)(elem.value());
+        BinDataType type = BinDataType(*(char *)((int *)(elem.value()) + 1));
+
+        if (type == mongo::bdtUUID || type == mongo::newUUID) {
+            _output.append(HexUtils::formatUuid(elem, _uuidEncoding));
+            return;
+        }
+
+        _output.append("{ \"$binary\" : \"");
+        char *start = (char *)(elem.value()) + sizeof(int) + 1;
+        _output.append(base64::encode(start, len));
+        _output.append("\", \"$type\" : \"");
+
+        // Hex of type as int, at least 2 digits (user defined types are negative)
+        static const char hexDigits[] = "0123456789abcdef";
+        unsigned int value = static_cast<unsigned int>(static_cast<int>(type));
+        char buffer[8];
+        int size = 0;
+        do {
+            buffer[sizeof(buffer) - ++size] = hexDigits[value & 0xF];
+            value >>= 4;
+        } while (value);
+        if (size < 2)
+            _output += '0';
+        _output.append(buffer + sizeof(buffer) - size, size);
+
+        _output.append("\" }");
+    }
+}
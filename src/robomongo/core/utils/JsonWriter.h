@@ -0,0 +1,52 @@
+#pragma once
+
+#include <string>
+#include <mongo/bson/bsonelement.h>
+#include <mongo/bson/bsonobj.h>
+
+#include "robomongo/core/Enums.h"
+
+namespace Robomongo
+{
+    /**
+     * @brief Writes JSON of BSON documents into one output buffer.
+     *
+     *        Nested objects and arrays are written in place, nothing is
+     *        formatted into temporary strings and copied to the parent.
+     *        Output is the same as BsonUtils::jsonString() always produced.
+     *
+     *        Output buffer is not cleared by writer, so the same buffer
+     *        (and its capacity) can be reused for many documents.
+     */
+    class JsonWriter
+    {
+    public:
+        JsonWriter(std::string &output, mongo::JsonStringFormat format,
+                   UUIDEncoding uuidEncoding, SupportedTimes timeFormat);
+
+        /**
+         * @param pretty: indentation level of fields, 0 to write in one line
+         * @param isArray: write 'obj' as array (it is also detected by BSONObj::isArray())
+         */
+        void writeObject(const mongo::BSONObj &obj, int pretty, bool isArray = false);
+        void writeElement(const mongo::BSONElement &elem, bool includeFieldNames, int pretty, bool isArray = false);
+
+    private:
+        void writeArray(const mongo::BSONObj &arr, int pretty);
+        void writeIndent(int level);
+        void writeDouble(double value);
+        void writeDate(const mongo::BSONElement &elem, int pretty);
+        void writeBinData(const mongo::BSONElement &elem);
+
+        std::string &_output;
+        const mongo::JsonStringFormat _format;
+        const UUIDEncoding _uuidEncoding;
+        const SupportedTimes _timeFormat;
+
+        /**
+         * @brief Spaces for the deepest level written so far,
+         * indentation is appended as prefix of it
+         */
+        std::string _indent;
+    };
+}
@@ -506,6 +506,7 @@ namespace Robomongo
         AppRegistry::instance().bus()->subscribe(this, ScriptExecutingEvent::Type);
         AppRegistry::instance().bus()->subscribe(this, QueryWidgetUpdatedEvent::Type);
         AppRegistry::instance().bus()->subscribe(this, OperationFailedEvent::Type);
+        AppRegistry::instance().bus()->subscribe(this, CopyCollectionProgressEvent::Type);
 
         restoreWindowsSettings();
     }
@@ -967,6 +968,18 @@ namespace Robomongo
         QMessageBox::information(NULL, "Operation failed", QtUtils::toQString(ss.str()));
     }
 
+    void MainWindow::handle(CopyCollectionProgressEvent *event)
+    {
+        QString message = QString("Copying to %1: %2 documents (%3 MB), %4 docs/s, %5 MB/s")
+            .arg(QtUtils::toQString(event->to().toString()))
+            .arg(event->documents())
+            .arg(event->bytes() / (1024.0 * 1024.0), 0, 'f', 1)
+            .arg(event->documentsPerSec(), 0, 'f', 0)
+            .arg(event->megabytesPerSec(), 0, 'f', 1);
+
+        statusBar()->showMessage(message, 5000);
+    }
+
     void MainWindow::closeEvent(QCloseEvent *event)
     {
         saveWindowsSettings();
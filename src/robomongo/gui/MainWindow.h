@@ -14,6 +14,7 @@ namespace Robomongo
     class ScriptExecutingEvent;
     class ScriptExecutedEvent;
     class OperationFailedEvent;
+    class CopyCollectionProgressEvent;
 
     class QueryWidgetUpdatedEvent;
     class WorkAreaTabWidget;
@@ -69,6 +70,7 @@ namespace Robomongo
         void handle(ScriptExecutedEvent *event);
         void handle(QueryWidgetUpdatedEvent *event);
         void handle(OperationFailedEvent *event);
+        void handle(CopyCollectionProgressEvent *event);
 
     protected:
         void closeEvent(QCloseEvent *event);
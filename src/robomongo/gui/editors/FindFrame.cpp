@@ -21,6 +21,7 @@ namespace Robomongo
         BaseClass(parent),
         _parent(parent),
         _scin(new RoboScintilla()),
+        _editorLayout(new QHBoxLayout()),
         _findPanel(new QFrame(this)),
         _close(new QToolButton(this)),
         _findLine(new QLineEdit(this)),
@@ -51,7 +52,10 @@ namespace Robomongo
         QVBoxLayout *mainLayout = new QVBoxLayout();
         mainLayout->setContentsMargins(0, 0, 0, 0);
         mainLayout->setSpacing(0);
-        mainLayout->addWidget(_scin, 1);
+        _editorLayout->setContentsMargins(0, 0, 0, 0);
+        _editorLayout->setSpacing(0);
+        _editorLayout->addWidget(_scin, 1);
+        mainLayout->addLayout(_editorLayout, 1);
         mainLayout->addWidget(_findPanel, 0, Qt::AlignBottom);
         setLayout(mainLayout);
 
@@ -120,7 +124,16 @@ namespace Robomongo
                index -= _scin->selectedText().length();
 
             _scin->setCursorPosition(line, 0);
-            bool isFounded = _scin->findFirst(text, re, _caseSensitive->checkState() == Qt::Checked, wo, looped, forward, line, index);
+            const bool cs = _caseSensitive->checkState() == Qt::Checked;
+            bool isFounded = _scin->findFirst(text, re, cs, wo, false, forward, line, index);
+
+            if (!isFounded && loadTextForSearch(text, cs, forward)) {
+                _scin->getCursorPosition(&line, &index);
+                isFounded = _scin->findFirst(text, re, cs, wo, false, forward, line, index);
+            }
+
+            if (!isFounded)
+                isFounded = _scin->findFirst(text, re, cs, wo, looped, forward, line, index);
 
             if (isFounded) {
                 _scin->ensureCursorVisible(); 
@@ -131,6 +144,11 @@ namespace Robomongo
         }
     }
     
+    bool FindFrame::loadTextForSearch(const QString &text, bool caseSensitive, bool forward)
+    {
+        return false;
+    }
+
     void FindFrame::toggleComments()
     {
         int lineFrom, indexFrom, lineTo, indexTo;
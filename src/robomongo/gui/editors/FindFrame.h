@@ -8,6 +8,7 @@ class QPushButton;
 class QToolButton;
 class QCheckBox;
 class QLineEdit;
+class QHBoxLayout;
 QT_END_NAMESPACE
 class QsciScintilla;
 
@@ -35,6 +36,20 @@ namespace Robomongo
         virtual void wheelEvent(QWheelEvent *e);
         virtual void keyPressEvent(QKeyEvent *e);
 
+        /**
+         * @brief Called when search reaches the end (or the beginning) of editor text.
+         * Frames, that show part of larger text, load next part containing 'text'
+         * and move cursor to its beginning (or end).
+         * @return true if such part is loaded, false to continue search
+         * from the other end of editor text
+         */
+        virtual bool loadTextForSearch(const QString &text, bool caseSensitive, bool forward);
+
+        /**
+         * @brief Layout with editor, widgets can be added next to it
+         */
+        QHBoxLayout *editorLayout() const { return _editorLayout; }
+
     private Q_SLOTS:
         void goToNextElement();
         void goToPrevElement();
@@ -43,6 +58,7 @@ namespace Robomongo
         void findElement(bool forward);
         void setLineComment(const int lineIndex, const bool commentOut);
         RoboScintilla *const _scin;
+        QHBoxLayout *const _editorLayout;
         QFrame *const _findPanel;
         QLineEdit *const _findLine;
         QToolButton *const _close;
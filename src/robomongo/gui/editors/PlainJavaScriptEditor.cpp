@@ -1,5 +1,6 @@
 #include "robomongo/gui/editors/PlainJavaScriptEditor.h"
 
+#include <algorithm>
 #include <QPainter>
 #include <QApplication>
 #include <QKeyEvent>
@@ -55,7 +56,8 @@ namespace Robomongo
         _ignoreEnterKey(false),
         _ignoreTabKey(false),
         _lineNumberDigitWidth(0),
-        _lineNumberMarginWidth(0)
+        _lineNumberMarginWidth(0),
+        _maxLineNumber(0)
     {
         setAutoIndent(true);
         setIndentationsUseTabs(false);
@@ -174,7 +176,7 @@ namespace Robomongo
 
     void RoboScintilla::updateLineNumbersMarginWidth()
     {
-        int numberOfDigits = getNumberOfDigits(lines());
+        int numberOfDigits = getNumberOfDigits(std::max(lines(), _maxLineNumber));
         _lineNumberMarginWidth = numberOfDigits * _lineNumberDigitWidth + rowNumberWidth;
 
         // If line numbers margin already displayed, update its width
@@ -183,6 +185,12 @@ namespace Robomongo
         }
     }
 
+    void RoboScintilla::setMaxLineNumber(int number)
+    {
+        _maxLineNumber = number;
+        updateLineNumbersMarginWidth();
+    }
+
     void RoboScintilla::setAppropriateBraceMatching() {
 #ifdef Q_OS_MAC
         // On Mac OS when brace matching is enabled, text
@@ -21,6 +21,12 @@ namespace Robomongo
         int textWidth(int style, const QString &text);
         void setAppropriateBraceMatching();
 
+        /**
+         * @brief Makes line numbers margin wide enough for numbers up to 'number',
+         * when margin shows numbers other than numbers of lines of editor
+         */
+        void setMaxLineNumber(int number);
+
     protected:
         void wheelEvent(QWheelEvent *e);
         void keyPressEvent(QKeyEvent *e);
@@ -35,5 +41,6 @@ namespace Robomongo
         bool _ignoreTabKey;
         int _lineNumberMarginWidth;
         int _lineNumberDigitWidth;
+        int _maxLineNumber;
     };
 }
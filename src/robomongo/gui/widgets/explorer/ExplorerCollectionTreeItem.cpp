@@ -2,6 +2,7 @@
 
 #include <QAction>
 #include <QMenu>
+#include <stdio.h>
 
 #include "robomongo/gui/widgets/explorer/EditIndexDialog.h"
 #include "robomongo/gui/widgets/explorer/ExplorerDatabaseTreeItem.h"
@@ -13,6 +14,7 @@
 
 #include "robomongo/core/settings/ConnectionSettings.h"
 #include "robomongo/core/domain/MongoCollection.h"
+#include "robomongo/core/domain/MetadataCache.h"
 #include "robomongo/core/domain/MongoServer.h"
 #include "robomongo/core/domain/App.h"
 #include "robomongo/core/utils/QtUtils.h"
@@ -32,43 +34,45 @@ namespace
 
 namespace Robomongo
 {
-    R_REGISTER_EVENT(CollectionIndexesLoadingEvent)
     const QString ExplorerCollectionDirIndexesTreeItem::labelText = "Indexes";
 
     ExplorerCollectionDirIndexesTreeItem::ExplorerCollectionDirIndexesTreeItem(QTreeWidgetItem *parent)
         :BaseClass(parent)
     {
-        QAction *addIndex = new QAction("Add Index...", this);
+        setText(0, labelText);
+        setIcon(0, Robomongo::GuiRegistry::instance().folderIcon());
+
+        setExpanded(false);
+        setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
+    }
+
+    void ExplorerCollectionDirIndexesTreeItem::buildContextMenu(QMenu *menu)
+    {
+        QAction *addIndex = new QAction("Add Index...", menu);
         VERIFY(connect(addIndex, SIGNAL(triggered()), SLOT(ui_addIndex())));
 
-        QAction *addIndexGui = new QAction("Add Index...", this);
+        QAction *addIndexGui = new QAction("Add Index...", menu);
         VERIFY(connect(addIndexGui, SIGNAL(triggered()), SLOT(ui_addIndexGui())));
 
-        QAction *dropIndex = new QAction("Drop Index...", this);
+        QAction *dropIndex = new QAction("Drop Index...", menu);
         VERIFY(connect(dropIndex, SIGNAL(triggered()), SLOT(ui_dropIndex())));
 
-        QAction *reIndex = new QAction("Rebuild Indexes...", this);
+        QAction *reIndex = new QAction("Rebuild Indexes...", menu);
         VERIFY(connect(reIndex, SIGNAL(triggered()), SLOT(ui_reIndex())));
 
-        QAction *viewIndex = new QAction("View Indexes", this);
+        QAction *viewIndex = new QAction("View Indexes", menu);
         VERIFY(connect(viewIndex, SIGNAL(triggered()), SLOT(ui_viewIndex())));
 
-        QAction *refreshIndex = new QAction("Refresh", this);
+        QAction *refreshIndex = new QAction("Refresh", menu);
         VERIFY(connect(refreshIndex, SIGNAL(triggered()), SLOT(ui_refreshIndex())));
 
-        BaseClass::_contextMenu->addAction(viewIndex);
-        //BaseClass::_contextMenu->addAction(addIndex);
-        BaseClass::_contextMenu->addAction(addIndexGui);
-        //BaseClass::_contextMenu->addAction(dropIndex);
-        BaseClass::_contextMenu->addAction(reIndex);
-        BaseClass::_contextMenu->addSeparator();
-        BaseClass::_contextMenu->addAction(refreshIndex);      
-
-        setText(0, labelText);
-        setIcon(0, Robomongo::GuiRegistry::instance().folderIcon());
-
-        setExpanded(false);
-        setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
+        menu->addAction(viewIndex);
+        //menu->addAction(addIndex);
+        menu->addAction(addIndexGui);
+        //menu->addAction(dropIndex);
+        menu->addAction(reIndex);
+        menu->addSeparator();
+        menu->addAction(refreshIndex);      
     }
 
     void ExplorerCollectionDirIndexesTreeItem::expand()
@@ -148,16 +152,19 @@ namespace Robomongo
     ExplorerCollectionIndexesTreeItem::ExplorerCollectionIndexesTreeItem(ExplorerCollectionDirIndexesTreeItem *parent, const EnsureIndexInfo &info)
         : BaseClass(parent), _info(info)
     {
-        QAction *deleteIndex = new QAction("Drop Index...", this);
+        setText(0, QtUtils::toQString(_info._name));
+        setIcon(0, Robomongo::GuiRegistry::instance().indexIcon());
+    }
+
+    void ExplorerCollectionIndexesTreeItem::buildContextMenu(QMenu *menu)
+    {
+        QAction *deleteIndex = new QAction("Drop Index...", menu);
         connect(deleteIndex, SIGNAL(triggered()), SLOT(ui_dropIndex()));
-        QAction *editIndex = new QAction("Edit Index...", this);
+        QAction *editIndex = new QAction("Edit Index...", menu);
         connect(editIndex, SIGNAL(triggered()), SLOT(ui_edit()));
 
-        BaseClass::_contextMenu->addAction(editIndex);
-        BaseClass::_contextMenu->addAction(deleteIndex);
-
-        setText(0, QtUtils::toQString(_info._name));
-        setIcon(0, Robomongo::GuiRegistry::instance().indexIcon());
+        menu->addAction(editIndex);
+        menu->addAction(deleteIndex);
     }
 
     void ExplorerCollectionIndexesTreeItem::ui_dropIndex()
@@ -201,86 +208,95 @@ namespace Robomongo
     }
 
     ExplorerCollectionTreeItem::ExplorerCollectionTreeItem(QTreeWidgetItem *parent, ExplorerDatabaseTreeItem *databaseItem, MongoCollection *collection) :
-        BaseClass(parent), _collection(collection), _databaseItem(databaseItem)
+        BaseClass(parent), _indexDir(NULL), _collection(collection), _databaseItem(databaseItem)
+    {
+        // Index responses are sent directly to this item, and 'Indexes'
+        // folder is created on first expand, so item of collection is cheap
+        // to create for databases with many collections
+        setText(0, QtUtils::toQString(_collection->name()));
+        setIcon(0, GuiRegistry::instance().collectionIcon());
+        updateStats();
+
+        setExpanded(false);
+        setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
+    }
+
+    void ExplorerCollectionTreeItem::buildContextMenu(QMenu *menu)
     {
-        QAction *addDocument = new QAction("Insert Document...", this);
+        QAction *addDocument = new QAction("Insert Document...", menu);
         VERIFY(connect(addDocument, SIGNAL(triggered()), SLOT(ui_addDocument())));
 
-        QAction *updateDocument = new QAction("Update Documents...", this);
+        QAction *updateDocument = new QAction("Update Documents...", menu);
         VERIFY(connect(updateDocument, SIGNAL(triggered()), SLOT(ui_updateDocument())));
-        QAction *removeDocument = new QAction("Remove Documents...", this);
+        QAction *removeDocument = new QAction("Remove Documents...", menu);
         VERIFY(connect(removeDocument, SIGNAL(triggered()), SLOT(ui_removeDocument())));
 
-        QAction *removeAllDocuments = new QAction("Remove All Documents...", this);
+        QAction *removeAllDocuments = new QAction("Remove All Documents...", menu);
         VERIFY(connect(removeAllDocuments, SIGNAL(triggered()), SLOT(ui_removeAllDocuments())));
 
-        QAction *collectionStats = new QAction("Statistics", this);
+        QAction *collectionStats = new QAction("Statistics", menu);
         VERIFY(connect(collectionStats, SIGNAL(triggered()), SLOT(ui_collectionStatistics())));
 
-        QAction *storageSize = new QAction("Storage Size", this);
+        QAction *storageSize = new QAction("Storage Size", menu);
         VERIFY(connect(storageSize, SIGNAL(triggered()), SLOT(ui_storageSize())));
 
-        QAction *totalIndexSize = new QAction("Total Index Size", this);
+        QAction *totalIndexSize = new QAction("Total Index Size", menu);
         VERIFY(connect(totalIndexSize, SIGNAL(triggered()), SLOT(ui_totalIndexSize())));
 
-        QAction *totalSize = new QAction("Total Size", this);
+        QAction *totalSize = new QAction("Total Size", menu);
         VERIFY(connect(totalSize, SIGNAL(triggered()), SLOT(ui_totalSize())));
-        QAction *shardVersion = new QAction("Shard Version", this);
+        QAction *shardVersion = new QAction("Shard Version", menu);
         VERIFY(connect(shardVersion, SIGNAL(triggered()), SLOT(ui_shardVersion())));
 
-        QAction *shardDistribution = new QAction("Shard Distribution", this);
+        QAction *shardDistribution = new QAction("Shard Distribution", menu);
         VERIFY(connect(shardDistribution, SIGNAL(triggered()), SLOT(ui_shardDistribution())));
 
-        QAction *dropCollection = new QAction("Drop Collection...", this);
+        QAction *dropCollection = new QAction("Drop Collection...", menu);
         VERIFY(connect(dropCollection, SIGNAL(triggered()), SLOT(ui_dropCollection())));
 
-        QAction *renameCollection = new QAction("Rename Collection...", this);
+        QAction *renameCollection = new QAction("Rename Collection...", menu);
         VERIFY(connect(renameCollection, SIGNAL(triggered()), SLOT(ui_renameCollection())));
-        QAction *duplicateCollection = new QAction("Duplicate Collection...", this);
+        QAction *duplicateCollection = new QAction("Duplicate Collection...", menu);
         VERIFY(connect(duplicateCollection, SIGNAL(triggered()), SLOT(ui_duplicateCollection())));
 
         // Disabling for 0.8.5 release as this is currently a broken misfeature (see discussion on issue #398)
-        // QAction *copyCollectionToDiffrentServer = new QAction("Copy Collection to Database...", this);
+        // QAction *copyCollectionToDiffrentServer = new QAction("Copy Collection to Database...", menu);
         // VERIFY(connect(copyCollectionToDiffrentServer, SIGNAL(triggered()), SLOT(ui_copyToCollectionToDiffrentServer())));
 
-        QAction *viewCollection = new QAction("View Documents", this);
+        QAction *viewCollection = new QAction("View Documents", menu);
         VERIFY(connect(viewCollection, SIGNAL(triggered()), SLOT(ui_viewCollection())));
 
-        BaseClass::_contextMenu->addAction(viewCollection);
-        BaseClass::_contextMenu->addSeparator();
-        BaseClass::_contextMenu->addAction(addDocument);
-        BaseClass::_contextMenu->addAction(updateDocument);
-        BaseClass::_contextMenu->addAction(removeDocument);
-        BaseClass::_contextMenu->addAction(removeAllDocuments);
-        BaseClass::_contextMenu->addSeparator();
-        BaseClass::_contextMenu->addAction(renameCollection);
-        BaseClass::_contextMenu->addAction(duplicateCollection);
+        menu->addAction(viewCollection);
+        menu->addSeparator();
+        menu->addAction(addDocument);
+        menu->addAction(updateDocument);
+        menu->addAction(removeDocument);
+        menu->addAction(removeAllDocuments);
+        menu->addSeparator();
+        menu->addAction(renameCollection);
+        menu->addAction(duplicateCollection);
         // Disabling for 0.8.5 release as this is currently a broken misfeature (see discussion on issue #398)
-        // BaseClass::_contextMenu->addAction(copyCollectionToDiffrentServer);
-        BaseClass::_contextMenu->addAction(dropCollection);
-        BaseClass::_contextMenu->addSeparator();
-        BaseClass::_contextMenu->addAction(collectionStats);
-        BaseClass::_contextMenu->addSeparator();
-        BaseClass::_contextMenu->addAction(shardVersion);
-        BaseClass::_contextMenu->addAction(shardDistribution);
-
-        AppRegistry::instance().bus()->subscribe(_databaseItem, LoadCollectionIndexesResponse::Type, this);
-        AppRegistry::instance().bus()->subscribe(_databaseItem, DeleteCollectionIndexResponse::Type, this);
-        AppRegistry::instance().bus()->subscribe(this, CollectionIndexesLoadingEvent::Type, this);
-        
-        setText(0, QtUtils::toQString(_collection->name()));
-        setIcon(0, GuiRegistry::instance().collectionIcon());
+        // menu->addAction(copyCollectionToDiffrentServer);
+        menu->addAction(dropCollection);
+        menu->addSeparator();
+        menu->addAction(collectionStats);
+        menu->addSeparator();
+        menu->addAction(shardVersion);
+        menu->addAction(shardDistribution);
+    }
 
-        _indexDir = new ExplorerCollectionDirIndexesTreeItem(this);
-        addChild(_indexDir);
-//        setToolTip(0, buildToolTip(collection));
+    void ExplorerCollectionTreeItem::createChildItems()
+    {
+        if (_indexDir)
+            return;
 
-        setExpanded(false);
-        setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
+        _indexDir = new ExplorerCollectionDirIndexesTreeItem(this);
     }
 
     void ExplorerCollectionTreeItem::handle(LoadCollectionIndexesResponse *event)
     {
+        createChildItems();
+
         if (event->isError()) {
             _indexDir->setText(0, "Indexes");
             _indexDir->setExpanded(false);
@@ -296,6 +312,9 @@ namespace Robomongo
         QtUtils::clearChildItems(_indexDir);
         const std::vector<EnsureIndexInfo> &indexes = event->indexes();
 
+        if (MetadataCache *cache = _collection->database()->server()->metadataCache())
+            cache->setIndexes(_collection->info().ns(), indexes);
+
         // Do not expand, when we do not have functions
         if (indexes.size() == 0)
             _indexDir->setExpanded(false);
@@ -308,7 +327,7 @@ namespace Robomongo
 
     void ExplorerCollectionTreeItem::handle(DeleteCollectionIndexResponse *event)
     {
-        if (event->isError()) {
+        if (event->isError() || !_indexDir) {
             return;
         }
 
@@ -327,14 +346,19 @@ namespace Robomongo
         _indexDir->setText(0, detail::buildName(ExplorerCollectionDirIndexesTreeItem::labelText, _indexDir->childCount()));
     }
 
-    void ExplorerCollectionTreeItem::handle(CollectionIndexesLoadingEvent *event)
-    {
-        _indexDir->setText(0, detail::buildName(ExplorerCollectionDirIndexesTreeItem::labelText, -1));
-    }
-
     void ExplorerCollectionTreeItem::expand()
     {
-         AppRegistry::instance().bus()->publish(new CollectionIndexesLoadingEvent(this));
+         createChildItems();
+
+         // Indexes from the cache of previous session are shown until they are loaded
+         std::vector<EnsureIndexInfo> cached;
+         MetadataCache *cache = _collection->database()->server()->metadataCache();
+         if (cache && _indexDir->childCount() == 0 && cache->indexes(_collection->info(), cached)) {
+             LoadCollectionIndexesResponse response(this, cached);
+             handle(&response);
+         }
+
+         _indexDir->setText(0, detail::buildName(ExplorerCollectionDirIndexesTreeItem::labelText, -1));
          if (_databaseItem) {
              _databaseItem->expandColection(this);
          }
@@ -348,12 +372,18 @@ namespace Robomongo
         _databaseItem->dropIndexFromCollection(this, QtUtils::toStdString(ind->text(0)));
     }
 
+    void ExplorerCollectionTreeItem::updateStats()
+    {
+        if (_collection->info().hasStats())
+            setToolTip(0, buildToolTip(_collection));
+    }
+
     QString ExplorerCollectionTreeItem::buildToolTip(MongoCollection *collection)
     {
-        // This function does not used now
         char buff[2048] = {0};
-//        sprintf(buff,tooltipTemplate,collection->name().c_str(),collection->info().count(),collection->sizeString().c_str());
-        return buff;
+        sprintf(buff, tooltipTemplate, collection->name().c_str(), collection->info().count(),
+                QtUtils::toStdString(collection->sizeString()).c_str());
+        return QString::fromUtf8(buff);
     }
 
     void ExplorerCollectionTreeItem::ui_addDocument()
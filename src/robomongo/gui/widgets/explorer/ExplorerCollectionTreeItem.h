@@ -13,12 +13,6 @@ namespace Robomongo
     class ExplorerCollectionDirIndexesTreeItem;
     class ExplorerDatabaseTreeItem;
 
-    class CollectionIndexesLoadingEvent : public Event
-    {
-        R_EVENT
-            CollectionIndexesLoadingEvent(QObject *sender) : Event(sender) {}
-    };
-
     class ExplorerCollectionTreeItem: public ExplorerTreeItem
     {
         Q_OBJECT
@@ -31,10 +25,22 @@ namespace Robomongo
         void openCurrentCollectionShell(const QString &script, bool execute = true, const CursorPosition &cursor = CursorPosition());
         ExplorerDatabaseTreeItem *const databaseItem() const { return _databaseItem; }
 
+        /**
+         * @brief Shows count and size of collection, when its statistics are loaded
+         */
+        void updateStats();
+
+        /**
+         * @brief Creates 'Indexes' folder, when collection is expanded first time
+         */
+        void createChildItems();
+
+    protected:
+        virtual void buildContextMenu(QMenu *menu);
+
     public Q_SLOTS:
         void handle(LoadCollectionIndexesResponse *event);
         void handle(DeleteCollectionIndexResponse *event);
-        void handle(CollectionIndexesLoadingEvent *event);
 
     private Q_SLOTS:
         void ui_addDocument();
@@ -69,6 +75,9 @@ namespace Robomongo
         explicit ExplorerCollectionDirIndexesTreeItem(QTreeWidgetItem *parent);
         void expand();
 
+    protected:
+        virtual void buildContextMenu(QMenu *menu);
+
     private Q_SLOTS:
         void ui_addIndex();
         void ui_addIndexGui();
@@ -85,6 +94,9 @@ namespace Robomongo
         typedef ExplorerTreeItem BaseClass;
         explicit ExplorerCollectionIndexesTreeItem(ExplorerCollectionDirIndexesTreeItem *parent, const EnsureIndexInfo &info);
 
+    protected:
+        virtual void buildContextMenu(QMenu *menu);
+
     private Q_SLOTS:
         void ui_dropIndex();
         void ui_edit();
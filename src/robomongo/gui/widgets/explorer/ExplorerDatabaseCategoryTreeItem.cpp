@@ -29,57 +29,60 @@ namespace Robomongo
 
     ExplorerDatabaseCategoryTreeItem::ExplorerDatabaseCategoryTreeItem(ExplorerDatabaseTreeItem *databaseItem, ExplorerDatabaseCategory category) :
         BaseClass(databaseItem), _category(category)
+    {
+        setExpanded(false);
+        setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
+    }
+
+    void ExplorerDatabaseCategoryTreeItem::buildContextMenu(QMenu *menu)
     {
         if (_category == Collections) {
-            QAction *createCollection = new QAction("Create Collection...", this);
+            QAction *createCollection = new QAction("Create Collection...", menu);
             VERIFY(connect(createCollection, SIGNAL(triggered()), SLOT(ui_createCollection())));
 
-            QAction *dbCollectionsStats = new QAction("Collections Statistics", this);
+            QAction *dbCollectionsStats = new QAction("Collections Statistics", menu);
             VERIFY(connect(dbCollectionsStats, SIGNAL(triggered()), SLOT(ui_dbCollectionsStatistics())));
 
-            QAction *refreshCollections = new QAction("Refresh", this);
+            QAction *refreshCollections = new QAction("Refresh", menu);
             VERIFY(connect(refreshCollections, SIGNAL(triggered()), SLOT(ui_refreshCollections())));
 
-            BaseClass::_contextMenu->addAction(dbCollectionsStats);
-            BaseClass::_contextMenu->addAction(createCollection);
-            BaseClass::_contextMenu->addSeparator();
-            BaseClass::_contextMenu->addAction(refreshCollections);
+            menu->addAction(dbCollectionsStats);
+            menu->addAction(createCollection);
+            menu->addSeparator();
+            menu->addAction(refreshCollections);
         }
         else if (_category == Users) {
 
-            QAction *refreshUsers = new QAction("Refresh", this);
+            QAction *refreshUsers = new QAction("Refresh", menu);
             VERIFY(connect(refreshUsers, SIGNAL(triggered()), SLOT(ui_refreshUsers())));
 
-            QAction *viewUsers = new QAction("View Users", this);
+            QAction *viewUsers = new QAction("View Users", menu);
             VERIFY(connect(viewUsers, SIGNAL(triggered()), SLOT(ui_viewUsers())));
 
-            QAction *addUser = new QAction("Add User...", this);
+            QAction *addUser = new QAction("Add User...", menu);
             VERIFY(connect(addUser, SIGNAL(triggered()), SLOT(ui_addUser())));
 
-            BaseClass::_contextMenu->addAction(viewUsers);
-            BaseClass::_contextMenu->addAction(addUser);
-            BaseClass::_contextMenu->addSeparator();
-            BaseClass::_contextMenu->addAction(refreshUsers);
+            menu->addAction(viewUsers);
+            menu->addAction(addUser);
+            menu->addSeparator();
+            menu->addAction(refreshUsers);
         }
         else if (_category == Functions) {
 
-            QAction *refreshFunctions = new QAction("Refresh", this);
+            QAction *refreshFunctions = new QAction("Refresh", menu);
             VERIFY(connect(refreshFunctions, SIGNAL(triggered()), SLOT(ui_refreshFunctions())));
 
-            QAction *viewFunctions = new QAction("View Functions", this);
+            QAction *viewFunctions = new QAction("View Functions", menu);
             VERIFY(connect(viewFunctions, SIGNAL(triggered()), SLOT(ui_viewFunctions())));
 
-            QAction *addFunction = new QAction("Add Function...", this);
+            QAction *addFunction = new QAction("Add Function...", menu);
             VERIFY(connect(addFunction, SIGNAL(triggered()), SLOT(ui_addFunction())));
 
-            BaseClass::_contextMenu->addAction(viewFunctions);
-            BaseClass::_contextMenu->addAction(addFunction);
-            BaseClass::_contextMenu->addSeparator();
-            BaseClass::_contextMenu->addAction(refreshFunctions);
+            menu->addAction(viewFunctions);
+            menu->addAction(addFunction);
+            menu->addSeparator();
+            menu->addAction(refreshFunctions);
         }
-
-        setExpanded(false);
-        setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
     }
     
     void ExplorerDatabaseCategoryTreeItem::expand()
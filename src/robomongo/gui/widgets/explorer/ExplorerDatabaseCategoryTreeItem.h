@@ -25,6 +25,9 @@ namespace Robomongo
         ExplorerDatabaseCategoryTreeItem(ExplorerDatabaseTreeItem *databaseItem, ExplorerDatabaseCategory category);
         void expand();
 
+    protected:
+        virtual void buildContextMenu(QMenu *menu);
+
     private Q_SLOTS:
         void ui_createCollection();
         void ui_addUser();
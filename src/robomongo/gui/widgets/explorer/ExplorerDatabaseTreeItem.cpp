@@ -3,6 +3,7 @@
 #include <QMessageBox>
 #include <QAction>
 #include <QMenu>
+#include <set>
 
 #include "robomongo/core/domain/MongoDatabase.h"
 #include "robomongo/core/domain/MongoCollection.h"
@@ -28,6 +29,47 @@ namespace
     {
         Robomongo::AppRegistry::instance().app()->openShell(database, script, execute, Robomongo::QtUtils::toQString(database->name()), cursor);
     }
+
+    /**
+     * @brief Inserts new child items of folder starting from 'position'.
+     * Consecutive new items are inserted with one insertChildren() call,
+     * because insertion of items one by one is slow for thousands of items.
+     */
+    class ChildItemsInserter
+    {
+    public:
+        ChildItemsInserter(QTreeWidgetItem *folder, int position) :
+            _folder(folder), _position(position) {}
+
+        void add(QTreeWidgetItem *item)
+        {
+            _items.append(item);
+        }
+
+        /**
+         * @brief Skips existing child item at current position
+         */
+        void skip()
+        {
+            flush();
+            ++_position;
+        }
+
+        void flush()
+        {
+            if (_items.isEmpty())
+                return;
+
+            _folder->insertChildren(_position, _items);
+            _position += _items.size();
+            _items.clear();
+        }
+
+    private:
+        QTreeWidgetItem *const _folder;
+        int _position;
+        QList<QTreeWidgetItem *> _items;
+    };
 }
 
 namespace Robomongo
@@ -48,31 +90,8 @@ namespace Robomongo
         _bus(AppRegistry::instance().bus()),
         _collectionSystemFolderItem(NULL)
     {
-        QAction *openDbShellAction = new QAction("Open Shell", this);
-        openDbShellAction->setIcon(GuiRegistry::instance().mongodbIcon());
-        VERIFY(connect(openDbShellAction, SIGNAL(triggered()), SLOT(ui_dbOpenShell())));
-
-        QAction *dbStats = new QAction("Database Statistics", this);
-        VERIFY(connect(dbStats, SIGNAL(triggered()), SLOT(ui_dbStatistics())));
-
-        QAction *dbDrop = new QAction("Drop Database...", this);
-        VERIFY(connect(dbDrop, SIGNAL(triggered()), SLOT(ui_dbDrop())));
-
-        QAction *dbRepair = new QAction("Repair Database...", this);
-        VERIFY(connect(dbRepair, SIGNAL(triggered()), SLOT(ui_dbRepair())));
-
-        QAction *refreshDatabase = new QAction("Refresh", this);
-        VERIFY(connect(refreshDatabase, SIGNAL(triggered()), SLOT(ui_refreshDatabase())));
-
-        BaseClass::_contextMenu->addAction(openDbShellAction);
-        BaseClass::_contextMenu->addAction(refreshDatabase);
-        BaseClass::_contextMenu->addSeparator();
-        BaseClass::_contextMenu->addAction(dbStats);
-        BaseClass::_contextMenu->addSeparator();
-        BaseClass::_contextMenu->addAction(dbRepair);
-        BaseClass::_contextMenu->addAction(dbDrop);
-
         _bus->subscribe(this, MongoDatabaseCollectionListLoadedEvent::Type, _database);
+        _bus->subscribe(this, MongoDatabaseCollectionStatsLoadedEvent::Type, _database);
         _bus->subscribe(this, MongoDatabaseUsersLoadedEvent::Type, _database);
         _bus->subscribe(this, MongoDatabaseFunctionsLoadedEvent::Type, _database);
         _bus->subscribe(this, MongoDatabaseCollectionsLoadingEvent::Type, _database);
@@ -100,11 +119,54 @@ namespace Robomongo
         addChild(_usersFolderItem);
     }
 
+    void ExplorerDatabaseTreeItem::buildContextMenu(QMenu *menu)
+    {
+        QAction *openDbShellAction = new QAction("Open Shell", menu);
+        openDbShellAction->setIcon(GuiRegistry::instance().mongodbIcon());
+        VERIFY(connect(openDbShellAction, SIGNAL(triggered()), SLOT(ui_dbOpenShell())));
+
+        QAction *dbStats = new QAction("Database Statistics", menu);
+        VERIFY(connect(dbStats, SIGNAL(triggered()), SLOT(ui_dbStatistics())));
+
+        QAction *dbDrop = new QAction("Drop Database...", menu);
+        VERIFY(connect(dbDrop, SIGNAL(triggered()), SLOT(ui_dbDrop())));
+
+        QAction *dbRepair = new QAction("Repair Database...", menu);
+        VERIFY(connect(dbRepair, SIGNAL(triggered()), SLOT(ui_dbRepair())));
+
+        QAction *refreshDatabase = new QAction("Refresh", menu);
+        VERIFY(connect(refreshDatabase, SIGNAL(triggered()), SLOT(ui_refreshDatabase())));
+
+        menu->addAction(openDbShellAction);
+        menu->addAction(refreshDatabase);
+        menu->addSeparator();
+        menu->addAction(dbStats);
+        menu->addSeparator();
+        menu->addAction(dbRepair);
+        menu->addAction(dbDrop);
+    }
+
     void ExplorerDatabaseTreeItem::expandCollections()
     {
         _database->loadCollections();
     }
 
+    bool ExplorerDatabaseTreeItem::showCollections()
+    {
+        if (_collectionFolderItem->isExpanded())
+            return false;
+
+        setExpanded(true);
+        _collectionFolderItem->setExpanded(true);
+        return true;
+    }
+
+    ExplorerCollectionTreeItem *ExplorerDatabaseTreeItem::collectionItem(const std::string &fullName) const
+    {
+        CollectionItemsType::const_iterator it = _collectionItems.find(fullName);
+        return it != _collectionItems.end() ? it->second : NULL;
+    }
+
     void ExplorerDatabaseTreeItem::expandUsers()
     {
         _database->loadUsers();
@@ -151,32 +213,69 @@ namespace Robomongo
         std::vector<MongoCollection *> collections = event->collections;
         int count = collections.size();
         _collectionFolderItem->setText(0, detail::buildName("Collections", count));
-        QtUtils::clearChildItems(_collectionFolderItem);
+        updateCollectionItems(collections);
 
         // Do not expand, when we do not have collections
-        if (count == 0) {
+        if (count == 0)
             _collectionFolderItem->setExpanded(false);
-            return;
+    }
+
+    void ExplorerDatabaseTreeItem::updateCollectionItems(const std::vector<MongoCollection *> &collections)
+    {
+        if (!_collectionSystemFolderItem) {
+            _collectionSystemFolderItem = new ExplorerTreeItem(_collectionFolderItem);
+            _collectionSystemFolderItem->setIcon(0, GuiRegistry::instance().folderIcon());
+            _collectionSystemFolderItem->setText(0, "System");
         }
 
-        _collectionSystemFolderItem = new ExplorerTreeItem(_collectionFolderItem);
-        _collectionSystemFolderItem->setIcon(0, GuiRegistry::instance().folderIcon());
-        _collectionSystemFolderItem->setText(0, "System");
-        _collectionFolderItem->addChild(_collectionSystemFolderItem);
+        // Items of removed collections are deleted. Other items are kept
+        // as they are, with expanded indexes and loaded statistics.
+        std::set<MongoCollection *> current(collections.begin(), collections.end());
+        CollectionItemsType::iterator it = _collectionItems.begin();
+        while (it != _collectionItems.end()) {
+            MongoCollection *collection = it->second->collection();
+            if (current.find(collection) != current.end() && collection->fullName() == it->first) {
+                ++it;
+                continue;
+            }
 
-        for (int i = 0; i < collections.size(); ++i) {
-            MongoCollection *collection = collections[i];
+            delete it->second;
+            _collectionItems.erase(it++);
+        }
 
-            if (collection->isSystem()) {
-                addSystemCollectionItem(collection);
-            } else {
-                addCollectionItem(collection);
+        // Items of new collections are inserted in the order of the list,
+        // the first child of "Collections" folder is "System" folder
+        ChildItemsInserter inserter(_collectionFolderItem, 1);
+        ChildItemsInserter systemInserter(_collectionSystemFolderItem, 0);
+        for (std::vector<MongoCollection *>::const_iterator it = collections.begin(); it != collections.end(); ++it) {
+            MongoCollection *collection = *it;
+            ChildItemsInserter &folderInserter = collection->isSystem() ? systemInserter : inserter;
+
+            if (_collectionItems.find(collection->fullName()) != _collectionItems.end()) {
+                folderInserter.skip();
+                continue;
             }
+
+            ExplorerCollectionTreeItem *item = new ExplorerCollectionTreeItem(NULL, this, collection);
+            folderInserter.add(item);
+            _collectionItems[collection->fullName()] = item;
         }
 
+        inserter.flush();
+        systemInserter.flush();
         showCollectionSystemFolderIfNeeded();
     }
 
+    void ExplorerDatabaseTreeItem::handle(MongoDatabaseCollectionStatsLoadedEvent *event)
+    {
+        std::vector<MongoCollection *> collections = event->collections;
+        for (std::vector<MongoCollection *>::const_iterator it = collections.begin(); it != collections.end(); ++it) {
+            CollectionItemsType::const_iterator found = _collectionItems.find((*it)->fullName());
+            if (found != _collectionItems.end())
+                found->second->updateStats();
+        }
+    }
+
     void ExplorerDatabaseTreeItem::handle(MongoDatabaseUsersLoadedEvent *event)
     {
         if (event->isError()) {
@@ -250,18 +349,6 @@ namespace Robomongo
         _usersFolderItem->setText(0, detail::buildName("Users", -1));
     }
 
-    void ExplorerDatabaseTreeItem::addCollectionItem(MongoCollection *collection)
-    {
-        ExplorerCollectionTreeItem *collectionItem = new ExplorerCollectionTreeItem(_collectionFolderItem, this, collection);
-        _collectionFolderItem->addChild(collectionItem);
-    }
-
-    void ExplorerDatabaseTreeItem::addSystemCollectionItem(MongoCollection *collection)
-    {
-        ExplorerCollectionTreeItem *collectionItem = new ExplorerCollectionTreeItem(_collectionSystemFolderItem, this, collection);
-        _collectionSystemFolderItem->addChild(collectionItem);
-    }
-
     void ExplorerDatabaseTreeItem::showCollectionSystemFolderIfNeeded()
     {
         _collectionSystemFolderItem->setHidden(_collectionSystemFolderItem->childCount() == 0);
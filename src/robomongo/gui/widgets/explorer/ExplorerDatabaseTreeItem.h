@@ -1,5 +1,8 @@
 #pragma once
 
+#include <map>
+#include <vector>
+
 #include "robomongo/gui/widgets/explorer/ExplorerTreeItem.h"
 
 namespace Robomongo
@@ -13,6 +16,7 @@ namespace Robomongo
     class ExplorerDatabaseCategoryTreeItem;
     class EventBus;
     class MongoDatabaseCollectionListLoadedEvent;
+    class MongoDatabaseCollectionStatsLoadedEvent;
     class MongoDatabaseUsersLoadedEvent;
     class MongoDatabaseFunctionsLoadedEvent;
     class MongoDatabaseCollectionsLoadingEvent;
@@ -34,6 +38,18 @@ namespace Robomongo
 
         MongoDatabase *database() const { return _database; }
         void expandCollections();
+
+        /**
+         * @brief Expands this item and "Collections" folder, collections are loaded then
+         * @return false, if folder is already expanded
+         */
+        bool showCollections();
+
+        /**
+         * @param fullName: full name of collection ("db.collection")
+         * @return item of collection, NULL if it is not created
+         */
+        ExplorerCollectionTreeItem *collectionItem(const std::string &fullName) const;
         void expandUsers();
         void expandFunctions();
         void expandColection(ExplorerCollectionTreeItem *const item);
@@ -41,8 +57,12 @@ namespace Robomongo
         void enshureIndex(ExplorerCollectionTreeItem *const item, const EnsureIndexInfo &oldInfo, const EnsureIndexInfo &newInfo);
         void editIndexFromCollection(ExplorerCollectionTreeItem *const item, const std::string& oldIndexText, const std::string& newIndexText);
 
+    protected:
+        virtual void buildContextMenu(QMenu *menu);
+
     public Q_SLOTS:
         void handle(MongoDatabaseCollectionListLoadedEvent *event);
+        void handle(MongoDatabaseCollectionStatsLoadedEvent *event);
         void handle(MongoDatabaseUsersLoadedEvent *event);
         void handle(MongoDatabaseFunctionsLoadedEvent *event);
         void handle(MongoDatabaseCollectionsLoadingEvent *event);
@@ -57,8 +77,13 @@ namespace Robomongo
         void ui_refreshDatabase();
 
     private:
-        void addCollectionItem(MongoCollection *collection);
-        void addSystemCollectionItem(MongoCollection *collection);
+        typedef std::map<std::string, ExplorerCollectionTreeItem *> CollectionItemsType;
+
+        /**
+         * @brief Applies difference between shown items and 'collections':
+         * adds items of new collections and deletes items of removed ones.
+         */
+        void updateCollectionItems(const std::vector<MongoCollection *> &collections);
         void showCollectionSystemFolderIfNeeded();
 
         void addUserItem(MongoDatabase *database, const MongoUser &user);
@@ -69,6 +94,7 @@ namespace Robomongo
         ExplorerDatabaseCategoryTreeItem *_javascriptFolderItem;
         ExplorerDatabaseCategoryTreeItem *_usersFolderItem;
         ExplorerTreeItem *_collectionSystemFolderItem;
+        CollectionItemsType _collectionItems;   // full name of collection -> item
         MongoDatabase *const _database;
     };
 }
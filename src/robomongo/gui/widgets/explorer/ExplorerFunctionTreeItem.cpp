@@ -21,21 +21,24 @@ namespace Robomongo
         _database(database)
     {
 
-        QAction *dropFunction = new QAction("Remove Function", this);
-        VERIFY(connect(dropFunction, SIGNAL(triggered()), SLOT(ui_dropFunction())));
-
-        QAction *editFunction = new QAction("Edit Function", this);
-        VERIFY(connect(editFunction, SIGNAL(triggered()), SLOT(ui_editFunction())));
-
-        BaseClass::_contextMenu->addAction(editFunction);
-        BaseClass::_contextMenu->addAction(dropFunction);
-
         setText(0, QtUtils::toQString(_function.name()));
         setIcon(0, GuiRegistry::instance().functionIcon());
         setToolTip(0, buildToolTip(_function));
         setExpanded(false);
     }
 
+    void ExplorerFunctionTreeItem::buildContextMenu(QMenu *menu)
+    {
+        QAction *dropFunction = new QAction("Remove Function", menu);
+        VERIFY(connect(dropFunction, SIGNAL(triggered()), SLOT(ui_dropFunction())));
+
+        QAction *editFunction = new QAction("Edit Function", menu);
+        VERIFY(connect(editFunction, SIGNAL(triggered()), SLOT(ui_editFunction())));
+
+        menu->addAction(editFunction);
+        menu->addAction(dropFunction);
+    }
+
     QString ExplorerFunctionTreeItem::buildToolTip(const MongoFunction &function)
     {
         return QString("%0").arg(QtUtils::toQString(function.name()));
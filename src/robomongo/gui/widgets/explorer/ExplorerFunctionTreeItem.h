@@ -16,6 +16,9 @@ namespace Robomongo
         MongoFunction function() const { return _function; }
         MongoDatabase *database() const { return _database; }
 
+    protected:
+        virtual void buildContextMenu(QMenu *menu);
+
     private Q_SLOTS:
         void ui_editFunction();        
         void ui_dropFunction();
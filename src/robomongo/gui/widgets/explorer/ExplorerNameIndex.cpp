@@ -0,0 +1,86 @@
+#include "robomongo/gui/widgets/explorer/ExplorerNameIndex.h"
+
+namespace Robomongo
+{
+    ExplorerNameIndex::ExplorerNameIndex(const std::vector<QString> &names)
+    {
+        _names.reserve(names.size());
+        _signatures.reserve(names.size());
+        for (std::vector<QString>::const_iterator it = names.begin(); it != names.end(); ++it) {
+            QString name = it->toLower();
+            _names.push_back(name);
+            _signatures.push_back(signature(name));
+        }
+    }
+
+    std::vector<int> ExplorerNameIndex::match(const QString &pattern, const std::vector<int> *candidates,
+                                              const volatile bool *stop) const
+    {
+        std::vector<int> result;
+        const quint64 patternSignature = signature(pattern);
+        const size_t count = candidates ? candidates->size() : _names.size();
+
+        for (size_t i = 0; i < count; ++i) {
+            // Check for interruption once per 4096 names
+            if (stop && (i & 0xFFF) == 0 && *stop)
+                break;
+
+            int position = candidates ? (*candidates)[i] : static_cast<int>(i);
+            if ((_signatures[position] & patternSignature) != patternSignature)
+                continue;
+
+            if (isSubsequence(pattern, _names[position]))
+                result.push_back(position);
+        }
+
+        return result;
+    }
+
+    quint64 ExplorerNameIndex::signature(const QString &text)
+    {
+        // Characters that differ by multiple of 64 share a bit, it is fine
+        // for rejecting names, because matching names are checked anyway
+        quint64 result = 0;
+        for (int i = 0; i < text.size(); ++i)
+            result |= Q_UINT64_C(1) << (text.at(i).unicode() & 63);
+        return result;
+    }
+
+    bool ExplorerNameIndex::isSubsequence(const QString &pattern, const QString &text)
+    {
+        const int patternSize = pattern.size();
+        const int textSize = text.size();
+        if (patternSize > textSize)
+            return false;
+
+        const QChar *p = pattern.constData();
+        const QChar *t = text.constData();
+        int matched = 0;
+        for (int i = 0; i < textSize && matched < patternSize; ++i) {
+            if (t[i] == p[matched])
+                ++matched;
+        }
+
+        return matched == patternSize;
+    }
+
+    ExplorerFilterThread::ExplorerFilterThread(const ExplorerNameIndexPtr &index, const QString &pattern,
+                                               const std::vector<int> &candidates, bool hasCandidates) :
+        _index(index),
+        _pattern(pattern),
+        _candidates(candidates),
+        _hasCandidates(hasCandidates),
+        _stop(false)
+    {
+    }
+
+    void ExplorerFilterThread::stop()
+    {
+        _stop = true;
+    }
+
+    void ExplorerFilterThread::run()
+    {
+        _matches = _index->match(_pattern, _hasCandidates ? &_candidates : NULL, &_stop);
+    }
+}
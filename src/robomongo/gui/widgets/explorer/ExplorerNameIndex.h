@@ -0,0 +1,83 @@
+#pragma once
+
+#include <QThread>
+#include <QString>
+#include <boost/shared_ptr.hpp>
+#include <vector>
+
+namespace Robomongo
+{
+    /**
+     * @brief Index of names of explorer items for fuzzy filter. Name matches
+     *        pattern when all characters of pattern are found in the name in
+     *        the same order, case insensitive ("usrlog" matches "users_log").
+     *
+     *        Lower case name and 64-bit signature of its characters are
+     *        prepared once, so most names are rejected by one AND of
+     *        signatures without looking at characters.
+     *
+     * @threadsafe index is not changed after construction and can be
+     *        matched from several threads
+     */
+    class ExplorerNameIndex
+    {
+    public:
+        explicit ExplorerNameIndex(const std::vector<QString> &names);
+
+        size_t size() const { return _names.size(); }
+
+        /**
+         * @brief Returns positions of names that match 'pattern'.
+         * @param pattern: lower case pattern
+         * @param candidates: positions of names to check, in ascending order,
+         *        or NULL to check all names. Names that match pattern also
+         *        match every its prefix, so matches of the previous pattern
+         *        can be used as candidates, when user continues typing.
+         * @param stop: matching is interrupted, when it becomes true
+         */
+        std::vector<int> match(const QString &pattern, const std::vector<int> *candidates = NULL,
+                               const volatile bool *stop = NULL) const;
+
+    private:
+        static quint64 signature(const QString &text);
+        static bool isSubsequence(const QString &pattern, const QString &text);
+
+        std::vector<QString> _names;        // lower case names
+        std::vector<quint64> _signatures;   // bit per character of the name
+    };
+
+    typedef boost::shared_ptr<const ExplorerNameIndex> ExplorerNameIndexPtr;
+
+    /**
+     * @brief Matches names of large index outside of GUI thread. Result is
+     *        available by matches() after 'finished' signal.
+     */
+    class ExplorerFilterThread : public QThread
+    {
+        Q_OBJECT
+
+    public:
+        ExplorerFilterThread(const ExplorerNameIndexPtr &index, const QString &pattern,
+                             const std::vector<int> &candidates, bool hasCandidates);
+
+        /**
+         * @brief Interrupts matching, result of stopped thread should be ignored
+         */
+        void stop();
+
+        ExplorerNameIndexPtr index() const { return _index; }
+        QString pattern() const { return _pattern; }
+        const std::vector<int> &matches() const { return _matches; }
+
+    protected:
+        virtual void run();
+
+    private:
+        const ExplorerNameIndexPtr _index;
+        const QString _pattern;
+        const std::vector<int> _candidates;
+        const bool _hasCandidates;
+        std::vector<int> _matches;
+        volatile bool _stop;
+    };
+}
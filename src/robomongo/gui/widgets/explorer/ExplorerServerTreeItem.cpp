@@ -29,52 +29,56 @@ namespace Robomongo
 {
     ExplorerServerTreeItem::ExplorerServerTreeItem(QTreeWidget *view, MongoServer *const server) : BaseClass(view),
         _server(server),
+        _systemFolder(NULL),
         _bus(AppRegistry::instance().bus())
     { 
-        QAction *openShellAction = new QAction("Open Shell", this);
+        _bus->subscribe(this, DatabaseListLoadedEvent::Type, _server);
+        _bus->subscribe(this, MongoServerLoadingDatabasesEvent::Type, _server);
+
+        setText(0, buildServerName());
+        setIcon(0, GuiRegistry::instance().serverIcon());
+        setExpanded(true);
+        setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
+    }
+
+    void ExplorerServerTreeItem::buildContextMenu(QMenu *menu)
+    {
+        QAction *openShellAction = new QAction("Open Shell", menu);
         openShellAction->setIcon(GuiRegistry::instance().mongodbIcon());
         VERIFY(connect(openShellAction, SIGNAL(triggered()), SLOT(ui_openShell())));
 
-        QAction *refreshServer = new QAction("Refresh", this);
+        QAction *refreshServer = new QAction("Refresh", menu);
         VERIFY(connect(refreshServer, SIGNAL(triggered()), SLOT(ui_refreshServer())));
 
-        QAction *createDatabase = new QAction("Create Database", this);
+        QAction *createDatabase = new QAction("Create Database", menu);
         VERIFY(connect(createDatabase, SIGNAL(triggered()), SLOT(ui_createDatabase())));
 
-        QAction *serverStatus = new QAction("Server Status", this);
+        QAction *serverStatus = new QAction("Server Status", menu);
         VERIFY(connect(serverStatus, SIGNAL(triggered()), SLOT(ui_serverStatus())));
 
-        QAction *serverVersion = new QAction("MongoDB Version", this);
+        QAction *serverVersion = new QAction("MongoDB Version", menu);
         VERIFY(connect(serverVersion, SIGNAL(triggered()), SLOT(ui_serverVersion())));
 
-        QAction *serverHostInfo = new QAction("Host Info", this);
+        QAction *serverHostInfo = new QAction("Host Info", menu);
         VERIFY(connect(serverHostInfo, SIGNAL(triggered()), SLOT(ui_serverHostInfo())));        
 
-        QAction *showLog = new QAction("Show Log", this);
+        QAction *showLog = new QAction("Show Log", menu);
         VERIFY(connect(showLog, SIGNAL(triggered()), SLOT(ui_showLog()))); 
 
-        QAction *disconnectAction = new QAction("Disconnect", this);
+        QAction *disconnectAction = new QAction("Disconnect", menu);
         disconnectAction->setIconText("Disconnect");
         VERIFY(connect(disconnectAction, SIGNAL(triggered()), SLOT(ui_disconnectServer())));
 
-        BaseClass::_contextMenu->addAction(openShellAction);
-        BaseClass::_contextMenu->addAction(refreshServer);
-        BaseClass::_contextMenu->addSeparator();
-        BaseClass::_contextMenu->addAction(createDatabase);
-        BaseClass::_contextMenu->addAction(serverStatus);
-        BaseClass::_contextMenu->addAction(serverHostInfo);
-        BaseClass::_contextMenu->addAction(serverVersion);
-        BaseClass::_contextMenu->addSeparator();
-        BaseClass::_contextMenu->addAction(showLog);
-        BaseClass::_contextMenu->addAction(disconnectAction);
-
-        _bus->subscribe(this, DatabaseListLoadedEvent::Type, _server);
-        _bus->subscribe(this, MongoServerLoadingDatabasesEvent::Type, _server);
-
-        setText(0, buildServerName());
-        setIcon(0, GuiRegistry::instance().serverIcon());
-        setExpanded(true);
-        setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
+        menu->addAction(openShellAction);
+        menu->addAction(refreshServer);
+        menu->addSeparator();
+        menu->addAction(createDatabase);
+        menu->addAction(serverStatus);
+        menu->addAction(serverHostInfo);
+        menu->addAction(serverVersion);
+        menu->addSeparator();
+        menu->addAction(showLog);
+        menu->addAction(disconnectAction);
     }
 
     void ExplorerServerTreeItem::expand()
@@ -82,37 +86,62 @@ namespace Robomongo
         _server->loadDatabases();
     }
 
+    ExplorerDatabaseTreeItem *ExplorerServerTreeItem::databaseItem(const std::string &name) const
+    {
+        DatabaseItemsType::const_iterator it = _databaseItems.find(name);
+        return it != _databaseItems.end() ? it->second : NULL;
+    }
+
     void ExplorerServerTreeItem::databaseRefreshed(const QList<MongoDatabase *> &dbs)
     {
         int count = dbs.count();
         setText(0, buildServerName(&count));
 
-        // Remove child items
-        QtUtils::clearChildItems(this);
-
         // Add 'System' folder
-        QIcon folderIcon = GuiRegistry::instance().folderIcon();
-        ExplorerTreeItem *systemFolder = new ExplorerTreeItem(this);
-        systemFolder->setIcon(0, folderIcon);
-        systemFolder->setText(0, "System");
-        addChild(systemFolder);
+        if (!_systemFolder) {
+            _systemFolder = new ExplorerTreeItem(this);
+            _systemFolder->setIcon(0, GuiRegistry::instance().folderIcon());
+            _systemFolder->setText(0, "System");
+        }
 
+        // Items of dropped databases are deleted. Other items are kept
+        // as they are, with expanded collections.
+        DatabaseItemsType::iterator it = _databaseItems.begin();
+        while (it != _databaseItems.end()) {
+            MongoDatabase *database = it->second->database();
+            if (dbs.contains(database) && database->name() == it->first) {
+                ++it;
+                continue;
+            }
+
+            delete it->second;
+            _databaseItems.erase(it++);
+        }
+
+        // Items of new databases are inserted in the order of the list,
+        // the first child of server is 'System' folder
+        int position = 1;
+        int systemPosition = 0;
         for (int i = 0; i < dbs.size(); i++)
         {
             MongoDatabase *database = dbs.at(i);
-
-            if (database->isSystem()) {
-                ExplorerDatabaseTreeItem *dbItem = new ExplorerDatabaseTreeItem(systemFolder, database);
-                systemFolder->addChild(dbItem);
-                continue;
+            ExplorerTreeItem *folder = database->isSystem() ? _systemFolder : this;
+            int &index = database->isSystem() ? systemPosition : position;
+
+            if (_databaseItems.find(database->name()) == _databaseItems.end()) {
+                ExplorerDatabaseTreeItem *dbItem = new ExplorerDatabaseTreeItem(folder, database);
+                if (folder->childCount() - 1 != index) {
+                    folder->removeChild(dbItem);
+                    folder->insertChild(index, dbItem);
+                }
+                _databaseItems[database->name()] = dbItem;
             }
 
-            ExplorerDatabaseTreeItem *dbItem = new ExplorerDatabaseTreeItem(this, database);
-            addChild(dbItem);
+            ++index;
         }
 
         // Show 'System' folder only if it has items
-        systemFolder->setHidden(systemFolder->childCount() == 0);
+        _systemFolder->setHidden(_systemFolder->childCount() == 0);
     }
 
     void ExplorerServerTreeItem::handle(DatabaseListLoadedEvent *event)
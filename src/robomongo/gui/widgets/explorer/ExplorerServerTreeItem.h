@@ -1,11 +1,14 @@
 #pragma once
 
+#include <map>
+
 #include "robomongo/core/events/MongoEvents.h"
 #include "robomongo/gui/widgets/explorer/ExplorerTreeItem.h"
 
 namespace Robomongo
 {
     class EventBus;
+    class ExplorerDatabaseTreeItem;
     class MongoServerLoadingDatabasesEvent;
 
     class ExplorerServerTreeItem : public ExplorerTreeItem
@@ -25,6 +28,16 @@ namespace Robomongo
         */
         void expand();
 
+        MongoServer *server() const { return _server; }
+
+        /**
+         * @brief Item of database, NULL if it is not shown
+         */
+        ExplorerDatabaseTreeItem *databaseItem(const std::string &name) const;
+
+    protected:
+        virtual void buildContextMenu(QMenu *menu);
+
     public Q_SLOTS:
         void databaseRefreshed(const QList<MongoDatabase *> &dbs);
         void handle(DatabaseListLoadedEvent *event);
@@ -50,7 +63,11 @@ namespace Robomongo
          */
         QString buildServerName(int *count = NULL);
 
+        typedef std::map<std::string, ExplorerDatabaseTreeItem *> DatabaseItemsType;
+
         MongoServer *const _server;
+        ExplorerTreeItem *_systemFolder;
+        DatabaseItemsType _databaseItems;   // name of database -> item
         EventBus *_bus;
     };
 }
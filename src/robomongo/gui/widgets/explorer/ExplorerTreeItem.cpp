@@ -7,25 +7,33 @@
 namespace Robomongo
 {
     ExplorerTreeItem::ExplorerTreeItem(QTreeWidgetItem *parent)
-        :QObject(), BaseClass(parent), _contextMenu(new QMenu(treeWidget()) )
+        :QObject(), BaseClass(parent)
     {
 
     }
 
     ExplorerTreeItem::ExplorerTreeItem(QTreeWidget *view)
-        :QObject(view), BaseClass(view), _contextMenu(new QMenu(view) )
+        :QObject(view), BaseClass(view)
     {
 
     }
 
     void ExplorerTreeItem::showContextMenuAtPos(const QPoint &pos)
     {
-        _contextMenu->exec(pos);
+        // Item can be deleted by the triggered action,
+        // so it should not be used after exec()
+        QMenu menu(treeWidget());
+        buildContextMenu(&menu);
+        if (!menu.isEmpty())
+            menu.exec(pos);
+    }
+
+    void ExplorerTreeItem::buildContextMenu(QMenu *menu)
+    {
     }
 
     ExplorerTreeItem::~ExplorerTreeItem()
     {
-        _contextMenu->deleteLater();
         QtUtils::clearChildItems(this);
     }
 }
@@ -14,11 +14,20 @@ namespace Robomongo
         typedef QTreeWidgetItem BaseClass;
         explicit ExplorerTreeItem(QTreeWidget *view);
         explicit ExplorerTreeItem(QTreeWidgetItem *parent);
+
+        /**
+         * @brief Shows context menu, that is built on demand by buildContextMenu(),
+         * so items do not keep their own menus and actions.
+         */
         virtual void showContextMenuAtPos(const QPoint &pos);
         using BaseClass::parent;
         virtual ~ExplorerTreeItem();
 
     protected:
-        QMenu *const _contextMenu;
+        /**
+         * @brief Adds actions of item to 'menu'. Actions should be created
+         * with 'menu' as parent, they are deleted together with the menu.
+         */
+        virtual void buildContextMenu(QMenu *menu);
     };
 }
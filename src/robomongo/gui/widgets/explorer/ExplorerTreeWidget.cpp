@@ -19,6 +19,10 @@ namespace Robomongo
         setHeaderHidden(true);
         setSelectionMode(QAbstractItemView::SingleSelection);
         setExpandsOnDoubleClick(false);
+
+        // All rows have the same height, so view does not measure every
+        // item of expanded folders with thousands of collections
+        setUniformRowHeights(true);
     }
 
     void ExplorerTreeWidget::contextMenuEvent(QContextMenuEvent *event)
@@ -33,15 +33,6 @@ namespace Robomongo
     ExplorerUserTreeItem::ExplorerUserTreeItem(QTreeWidgetItem *parent, MongoDatabase *const database, const MongoUser &user) :
         BaseClass(parent), _user(user), _database(database)
     {
-        QAction *dropUser = new QAction("Drop User", this);
-        VERIFY(connect(dropUser, SIGNAL(triggered()), SLOT(ui_dropUser())));
-
-        QAction *editUser = new QAction("Edit User", this);
-        VERIFY(connect(editUser, SIGNAL(triggered()), SLOT(ui_editUser())));
-
-        BaseClass::_contextMenu->addAction(editUser);
-        BaseClass::_contextMenu->addAction(dropUser);
-
         setText(0, QtUtils::toQString(_user.name()));
         setIcon(0, GuiRegistry::instance().userIcon());
         setExpanded(false);
@@ -49,6 +40,18 @@ namespace Robomongo
         setToolTip(0, QtUtils::toQString(buildToolTip(user)));
     }
 
+    void ExplorerUserTreeItem::buildContextMenu(QMenu *menu)
+    {
+        QAction *dropUser = new QAction("Drop User", menu);
+        VERIFY(connect(dropUser, SIGNAL(triggered()), SLOT(ui_dropUser())));
+
+        QAction *editUser = new QAction("Edit User", menu);
+        VERIFY(connect(editUser, SIGNAL(triggered()), SLOT(ui_editUser())));
+
+        menu->addAction(editUser);
+        menu->addAction(dropUser);
+    }
+
     void ExplorerUserTreeItem::ui_dropUser()
     {
         // Ask user
@@ -14,6 +14,9 @@ namespace Robomongo
         typedef ExplorerTreeItem BaseClass;
         ExplorerUserTreeItem(QTreeWidgetItem *parent, MongoDatabase *const database, const MongoUser &user);
 
+    protected:
+        virtual void buildContextMenu(QMenu *menu);
+
     private Q_SLOTS:
         void ui_dropUser();
         void ui_editUser();
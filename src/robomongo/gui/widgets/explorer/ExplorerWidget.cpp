@@ -1,33 +1,57 @@
 #include "robomongo/gui/widgets/explorer/ExplorerWidget.h"
 
-#include <QHBoxLayout>
+#include <algorithm>
+#include <QVBoxLayout>
 #include <QLabel>
+#include <QLineEdit>
 #include <QMovie>
 #include <QKeyEvent>
+#include <QSet>
+#include <QTimer>
 
 #include "robomongo/core/AppRegistry.h"
 #include "robomongo/core/domain/App.h"
+#include "robomongo/core/domain/MongoDatabase.h"
+#include "robomongo/core/domain/MongoServer.h"
 #include "robomongo/core/utils/QtUtils.h"
 
 #include "robomongo/gui/widgets/explorer/ExplorerTreeWidget.h"
 #include "robomongo/gui/widgets/explorer/ExplorerServerTreeItem.h"
 #include "robomongo/gui/widgets/explorer/ExplorerCollectionTreeItem.h"
+#include "robomongo/gui/widgets/explorer/ExplorerDatabaseTreeItem.h"
 #include "robomongo/gui/widgets/explorer/ExplorerDatabaseCategoryTreeItem.h"
 
 namespace Robomongo
 {
 
     ExplorerWidget::ExplorerWidget(QWidget *parent) : BaseClass(parent),
-        _progress(0)
+        _progress(0),
+        _filterThread(NULL),
+        _isFiltered(false)
     {
         _treeWidget = new ExplorerTreeWidget(this);
 
-        QHBoxLayout *vlaout = new QHBoxLayout();
+        _filterEdit = new QLineEdit(this);
+        _filterEdit->setPlaceholderText("Filter");
+        _filterEdit->setClearButtonEnabled(true);
+
+        // Filter is applied again, when items are added or removed
+        _filterTimer = new QTimer(this);
+        _filterTimer->setSingleShot(true);
+        _filterTimer->setInterval(100);
+
+        QVBoxLayout *vlaout = new QVBoxLayout();
         vlaout->setMargin(0);
-        vlaout->addWidget(_treeWidget, Qt::AlignJustify);
+        vlaout->setSpacing(1);
+        vlaout->addWidget(_filterEdit);
+        vlaout->addWidget(_treeWidget);
 
         VERIFY(connect(_treeWidget, SIGNAL(itemExpanded(QTreeWidgetItem *)), this, SLOT(ui_itemExpanded(QTreeWidgetItem *))));
         VERIFY(connect(_treeWidget, SIGNAL(itemDoubleClicked(QTreeWidgetItem *, int)), this, SLOT(ui_itemDoubleClicked(QTreeWidgetItem *, int))));
+        VERIFY(connect(_treeWidget->model(), SIGNAL(rowsInserted(const QModelIndex &, int, int)), this, SLOT(ui_explorerChanged())));
+        VERIFY(connect(_treeWidget->model(), SIGNAL(rowsRemoved(const QModelIndex &, int, int)), this, SLOT(ui_explorerChanged())));
+        VERIFY(connect(_filterEdit, SIGNAL(textChanged(const QString &)), this, SLOT(ui_filterTextChanged())));
+        VERIFY(connect(_filterTimer, SIGNAL(timeout()), this, SLOT(applyFilter())));
 
         setLayout(vlaout);
 
@@ -38,6 +62,15 @@ namespace Robomongo
         movie->start();        
     }
 
+    ExplorerWidget::~ExplorerWidget()
+    {
+        stopFilterThread();
+        for (std::vector<ExplorerFilterThread *>::const_iterator it = _stoppedFilterThreads.begin(); it != _stoppedFilterThreads.end(); ++it) {
+            (*it)->wait();
+            delete *it;
+        }
+    }
+
     void ExplorerWidget::keyPressEvent(QKeyEvent *event)
     {
         if ((event->key() == Qt::Key_Return) || (event->key() == Qt::Key_Enter))
@@ -61,6 +94,12 @@ namespace Robomongo
             return;
         }
 
+        if (event->key() == Qt::Key_Escape && !_filterEdit->text().isEmpty()) {
+            _filterEdit->clear();
+            _treeWidget->setFocus();
+            return;
+        }
+
         BaseClass::keyPressEvent(event);
     }
 
@@ -120,6 +159,12 @@ namespace Robomongo
             return;
         }
        
+        ExplorerCollectionTreeItem *collectionItem = dynamic_cast<ExplorerCollectionTreeItem *>(item);
+        if (collectionItem) {
+            collectionItem->createChildItems();
+            return;
+        }
+
         ExplorerCollectionDirIndexesTreeItem * dirItem = dynamic_cast<ExplorerCollectionDirIndexesTreeItem *>(item);
         if (dirItem) {
             dirItem->expand();
@@ -137,4 +182,219 @@ namespace Robomongo
         // Toggle expanded state
         item->setExpanded(!item->isExpanded());
     }
+
+    void ExplorerWidget::ui_filterTextChanged()
+    {
+        applyFilter();
+    }
+
+    void ExplorerWidget::applyFilter()
+    {
+        QString pattern = _filterEdit->text().toLower();
+        pattern.remove(QChar(' '));
+
+        if (pattern.isEmpty()) {
+            clearFilter();
+            return;
+        }
+
+        if (!_filterIndex)
+            buildFilterIndex();
+
+        // Names that match pattern match also its prefixes,
+        // so only matches of the previous pattern are checked
+        const bool hasCandidates = !_filterPattern.isEmpty() && pattern.startsWith(_filterPattern);
+        const size_t count = hasCandidates ? _filterMatches.size() : _filterIndex->size();
+
+        stopFilterThread();
+
+        if (count <= asyncFilterThreshold) {
+            setFilterMatches(pattern, _filterIndex->match(pattern, hasCandidates ? &_filterMatches : NULL));
+            return;
+        }
+
+        _filterThread = new ExplorerFilterThread(_filterIndex, pattern,
+            hasCandidates ? _filterMatches : std::vector<int>(), hasCandidates);
+        VERIFY(connect(_filterThread, SIGNAL(finished()), this, SLOT(ui_filterMatched())));
+        _filterThread->start();
+    }
+
+    void ExplorerWidget::ui_filterMatched()
+    {
+        ExplorerFilterThread *thread = qobject_cast<ExplorerFilterThread *>(sender());
+        if (!thread)
+            return;
+
+        thread->deleteLater();
+
+        // Thread was stopped, because pattern is changed
+        if (thread != _filterThread) {
+            _stoppedFilterThreads.erase(std::remove(_stoppedFilterThreads.begin(), _stoppedFilterThreads.end(), thread),
+                                        _stoppedFilterThreads.end());
+            return;
+        }
+
+        _filterThread = NULL;
+
+        // Items were changed during matching
+        if (thread->index() != _filterIndex) {
+            applyFilter();
+            return;
+        }
+
+        setFilterMatches(thread->pattern(), thread->matches());
+    }
+
+    void ExplorerWidget::stopFilterThread()
+    {
+        if (!_filterThread)
+            return;
+
+        _filterThread->stop();
+        _stoppedFilterThreads.push_back(_filterThread);
+        _filterThread = NULL;
+    }
+
+    void ExplorerWidget::ui_explorerChanged()
+    {
+        // Entries may point to deleted items
+        _filterIndex.reset();
+        _filterEntries.clear();
+        _filterPattern.clear();
+        _filterMatches.clear();
+
+        if (_isFiltered)
+            _filterTimer->start();
+    }
+
+    void ExplorerWidget::buildFilterIndex()
+    {
+        _filterEntries.clear();
+        _filterPattern.clear();
+        _filterMatches.clear();
+
+        std::vector<QString> names;
+        for (int i = 0; i < _treeWidget->topLevelItemCount(); ++i) {
+            if (ExplorerServerTreeItem *serverItem = dynamic_cast<ExplorerServerTreeItem *>(_treeWidget->topLevelItem(i)))
+                collectFilterEntries(serverItem, names);
+        }
+
+        _filterIndex.reset(new ExplorerNameIndex(names));
+    }
+
+    void ExplorerWidget::collectFilterEntries(ExplorerServerTreeItem *serverItem, std::vector<QString> &names)
+    {
+        MongoServer *server = serverItem->server();
+        QStringList databases = server->getDatabasesNames();
+        for (QStringList::const_iterator it = databases.begin(); it != databases.end(); ++it) {
+            std::string name = QtUtils::toStdString(*it);
+            ExplorerDatabaseTreeItem *databaseItem = serverItem->databaseItem(name);
+            const int database = _filterEntries.size();
+            _filterEntries.push_back(FilterEntry(databaseItem, databaseItem, -1));
+            names.push_back(*it);
+
+            // Collections of databases that were not expanded are known from cache
+            std::vector<std::string> collections;
+            if (!server->findDatabaseByName(name)->collectionNames(collections))
+                continue;
+
+            for (std::vector<std::string>::const_iterator col = collections.begin(); col != collections.end(); ++col) {
+                QTreeWidgetItem *item = databaseItem ? databaseItem->collectionItem(*col) : NULL;
+                _filterEntries.push_back(FilterEntry(item, databaseItem, database));
+                names.push_back(QtUtils::toQString(MongoNamespace(*col).collectionName()));
+            }
+        }
+    }
+
+    void ExplorerWidget::setFilterMatches(const QString &pattern, const std::vector<int> &matches)
+    {
+        _filterPattern = pattern;
+        _filterMatches = matches;
+        _isFiltered = true;
+
+        const size_t count = _filterEntries.size();
+        std::vector<bool> matched(count, false);
+        for (std::vector<int>::const_iterator it = matches.begin(); it != matches.end(); ++it)
+            matched[*it] = true;
+
+        // Database is shown with matching collections, collection is shown with matching database
+        std::vector<bool> visible(matched);
+        for (size_t i = 0; i < count; ++i) {
+            int database = _filterEntries[i].database;
+            if (database == -1)
+                continue;
+
+            if (matched[i])
+                visible[database] = true;
+            if (matched[database])
+                visible[i] = true;
+        }
+
+        // Folders between server and items ("System", "Collections")
+        // are shown only if they have visible items
+        QSet<QTreeWidgetItem *> folders;
+        QSet<QTreeWidgetItem *> visibleFolders;
+        std::vector<ExplorerDatabaseTreeItem *> expanded;
+        for (size_t i = 0; i < count; ++i) {
+            QTreeWidgetItem *item = _filterEntries[i].item;
+            if (!item) {
+                ExplorerDatabaseTreeItem *databaseItem = _filterEntries[i].databaseItem;
+                if (matched[i] && databaseItem && expanded.size() < maxFilterExpandedDatabases
+                    && std::find(expanded.begin(), expanded.end(), databaseItem) == expanded.end())
+                    expanded.push_back(databaseItem);
+                continue;
+            }
+
+            if (item->isHidden() == visible[i])
+                item->setHidden(!visible[i]);
+
+            QTreeWidgetItem *folder = item->parent();
+            if (!folder || !folder->parent())
+                continue;
+
+            folders.insert(folder);
+            if (visible[i])
+                visibleFolders.insert(folder);
+        }
+
+        for (QSet<QTreeWidgetItem *>::const_iterator it = folders.begin(); it != folders.end(); ++it)
+            (*it)->setHidden(!visibleFolders.contains(*it));
+
+        // Items of collections are created from cache when database is expanded,
+        // this resets entries, and filter is applied again by _filterTimer
+        for (std::vector<ExplorerDatabaseTreeItem *>::const_iterator it = expanded.begin(); it != expanded.end(); ++it)
+            (*it)->showCollections();
+    }
+
+    void ExplorerWidget::clearFilter()
+    {
+        stopFilterThread();
+
+        _filterPattern.clear();
+        _filterMatches.clear();
+
+        if (!_isFiltered)
+            return;
+
+        _isFiltered = false;
+        if (!_filterIndex)
+            buildFilterIndex();
+
+        QSet<QTreeWidgetItem *> folders;
+        for (std::vector<FilterEntry>::const_iterator it = _filterEntries.begin(); it != _filterEntries.end(); ++it) {
+            if (!it->item)
+                continue;
+
+            if (it->item->isHidden())
+                it->item->setHidden(false);
+
+            QTreeWidgetItem *folder = it->item->parent();
+            if (folder && folder->parent())
+                folders.insert(folder);
+        }
+
+        // Empty "System" folders are hidden without filter too
+        for (QSet<QTreeWidgetItem *>::const_iterator it = folders.begin(); it != folders.end(); ++it)
+            (*it)->setHidden((*it)->childCount() == 0);
+    }
 }
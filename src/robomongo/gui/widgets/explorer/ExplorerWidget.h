@@ -5,12 +5,18 @@ QT_BEGIN_NAMESPACE
 class QTreeWidget;
 class QTreeWidgetItem;
 class QLabel;
+class QLineEdit;
+class QTimer;
 QT_END_NAMESPACE
 
 #include "robomongo/core/events/MongoEvents.h"
+#include "robomongo/gui/widgets/explorer/ExplorerNameIndex.h"
 
 namespace Robomongo
 {
+    class ExplorerServerTreeItem;
+    class ExplorerDatabaseTreeItem;
+
     /**
      * @brief Explorer widget (usually you'll see it at the left of main window)
      */
@@ -20,7 +26,21 @@ namespace Robomongo
 
     public:
         typedef QWidget BaseClass;
+
+        /**
+         * @brief Filter is matched outside of GUI thread, when there are
+         * more candidate names than this
+         */
+        enum { asyncFilterThreshold = 20000 };
+
+        /**
+         * @brief Filter expands at most this many databases with matching
+         * collections, that are not shown yet
+         */
+        enum { maxFilterExpandedDatabases = 20 };
+
         ExplorerWidget(QWidget *parent);
+        ~ExplorerWidget();
 
     protected Q_SLOTS:
         void handle(ConnectingEvent *event);
@@ -29,15 +49,64 @@ namespace Robomongo
     private Q_SLOTS:
         void ui_itemExpanded(QTreeWidgetItem *item);
         void ui_itemDoubleClicked(QTreeWidgetItem *item, int column);
+        void ui_filterTextChanged();
+        void ui_filterMatched();
+        void ui_explorerChanged();
+        void applyFilter();
 
     protected:
         virtual void keyPressEvent(QKeyEvent *event);   
 
     private:
+        /**
+         * @brief Database or collection, that is shown or hidden by filter
+         */
+        struct FilterEntry
+        {
+            FilterEntry(QTreeWidgetItem *item, ExplorerDatabaseTreeItem *databaseItem, int database) :
+                item(item), databaseItem(databaseItem), database(database) {}
+            QTreeWidgetItem *item;  // NULL, if collection is cached, but its item is not created
+            ExplorerDatabaseTreeItem *databaseItem;
+            int database;           // entry of database of collection, -1 for database
+        };
+
         int _progress;
         void increaseProgress();
         void decreaseProgress();
+
+        /**
+         * @brief Builds index of names of databases of servers in explorer and their
+         * collections, that are loaded or cached. Collections of databases that were
+         * not expanded yet are indexed too.
+         */
+        void buildFilterIndex();
+        void collectFilterEntries(ExplorerServerTreeItem *serverItem, std::vector<QString> &names);
+
+        /**
+         * @brief Shows items that match filter, databases of matching collections,
+         * and collections of matching databases. Hides the rest. Databases with
+         * matching collections, that have no items yet, are expanded.
+         */
+        void setFilterMatches(const QString &pattern, const std::vector<int> &matches);
+        void clearFilter();
+
+        /**
+         * @brief Stops current filter thread. Thread is deleted when it is
+         * finished, or by destructor, that waits for it.
+         */
+        void stopFilterThread();
+
         QLabel *_progressLabel;
         QTreeWidget *_treeWidget;
+        QLineEdit *_filterEdit;
+        QTimer *_filterTimer;                       // applies filter after explorer is changed
+
+        ExplorerNameIndexPtr _filterIndex;          // NULL, when explorer is changed after building
+        std::vector<FilterEntry> _filterEntries;    // entries in the order of names in _filterIndex
+        QString _filterPattern;                     // pattern of _filterMatches
+        std::vector<int> _filterMatches;
+        ExplorerFilterThread *_filterThread;        // thread that matches current pattern
+        std::vector<ExplorerFilterThread *> _stoppedFilterThreads; // stopped threads, that are not finished yet
+        bool _isFiltered;
     };
 }
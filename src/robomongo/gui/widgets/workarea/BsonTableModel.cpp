@@ -1,7 +1,9 @@
 #include "robomongo/gui/widgets/workarea/BsonTableModel.h"
 
+#include <algorithm>
 #include <QBrush>
 #include <QIcon>
+#include <QSet>
 
 #include "robomongo/gui/widgets/workarea/BsonTreeItem.h"
 #include "robomongo/gui/widgets/workarea/BsonTreeModel.h"
@@ -10,7 +12,7 @@
 namespace Robomongo
 {
     BsonTableModelProxy::BsonTableModelProxy(QObject *parent) 
-        : BaseClass(parent)
+        : BaseClass(parent), _root(NULL)
     {
        
     }
@@ -41,7 +43,7 @@ namespace Robomongo
         if (!node || _columns.size() <= col)
             return QModelIndex();
 
-        BsonTreeItem *child = node->childByKey(_columns[col]);
+        BsonTreeItem *child = cell(node, row, col);
 
         return createIndex( row, col, child );
     }
@@ -57,7 +59,7 @@ namespace Robomongo
         if (!node || _columns.size() <= col)
             return QModelIndex();
 
-        BsonTreeItem *child = node->childByKey(_columns[col]);
+        BsonTreeItem *child = cell(node, row, col);
 
         return createIndex( row, col, child );
     }
@@ -73,7 +75,7 @@ namespace Robomongo
         BsonTreeItem *child = static_cast<BsonTreeItem *>(proxyIndex.internalPointer());
         if (child) {
             QtUtils::HackQModelIndex* hack = reinterpret_cast<QtUtils::HackQModelIndex*>(&sourceIndex);
-            BsonTreeItem *parent = static_cast<BsonTreeItem *>(child->parent());
+            BsonTreeItem *parent = child->parent();
             hack->r = proxyIndex.row();
             hack->c = proxyIndex.column();
             hack->i = parent;
@@ -87,22 +89,152 @@ namespace Robomongo
         if (model) {
             BsonTreeItem *child = QtUtils::item<BsonTreeItem *>(model->index(0, 0));
             if (child) {
-                _root = qobject_cast<BsonTreeItem *>(child->parent());
+                _root = child->parent();
                 if (_root) {
                     int count = _root->childrenCount();
+                    _cells.reserve(count);
                     for (int i = 0; i < count; ++i) {
+                        fetchDocument(model, i);
                         BsonTreeItem *child = _root->child(i);
                         int countc = child->childrenCount();
                         for (int j = 0; j < countc; ++j) {
                             addColumn(child->child(j)->key());
                         }
+                        _cells.push_back(indexDocument(model, i));
                     }
                 }
             }
+            VERIFY(connect(model, SIGNAL(rowsAboutToBeInserted(const QModelIndex &, int, int)),
+                           this, SLOT(sourceRowsAboutToBeInserted(const QModelIndex &, int, int))));
+            VERIFY(connect(model, SIGNAL(rowsInserted(const QModelIndex &, int, int)),
+                           this, SLOT(sourceRowsInserted(const QModelIndex &, int, int))));
+            VERIFY(connect(model, SIGNAL(rowsAboutToBeRemoved(const QModelIndex &, int, int)),
+                           this, SLOT(sourceRowsAboutToBeRemoved(const QModelIndex &, int, int))));
+            VERIFY(connect(model, SIGNAL(rowsRemoved(const QModelIndex &, int, int)),
+                           this, SLOT(sourceRowsRemoved(const QModelIndex &, int, int))));
         }
         return BaseClass::setSourceModel(model);
     }
 
+    void BsonTableModelProxy::sourceRowsAboutToBeInserted(const QModelIndex &parent, int first, int last)
+    {
+        // Only documents (top-level rows) are shown in the table
+        if (parent.isValid())
+            return;
+
+        beginInsertRows(QModelIndex(), first, last);
+    }
+
+    void BsonTableModelProxy::sourceRowsInserted(const QModelIndex &parent, int first, int last)
+    {
+        if (parent.isValid())
+            return;
+
+        _cells.insert(_cells.begin() + first, last - first + 1, ColumnRowsType());
+        endInsertRows();
+
+        // Appended documents may have fields that are not shown yet
+        ColumnsValuesType newColumns;
+        QSet<QString> newColumnKeys;
+        for (int i = first; i <= last; ++i) {
+            fetchDocument(sourceModel(), i);
+            BsonTreeItem *child = QtUtils::item<BsonTreeItem *>(sourceModel()->index(i, 0));
+            if (!child)
+                continue;
+
+            if (!_root)
+                _root = child->parent();
+
+            int countc = child->childrenCount();
+            for (int j = 0; j < countc; ++j) {
+                QString key = child->child(j)->key();
+                if (findIndexColumn(key) == _columns.size() && !newColumnKeys.contains(key)) {
+                    newColumnKeys.insert(key);
+                    newColumns.push_back(key);
+                }
+            }
+        }
+
+        if (!newColumns.empty()) {
+            beginInsertColumns(QModelIndex(), _columns.size(), _columns.size() + newColumns.size() - 1);
+            for (ColumnsValuesType::const_iterator it = newColumns.begin(); it != newColumns.end(); ++it) {
+                addColumn(*it);
+            }
+            endInsertColumns();
+        }
+
+        for (int i = first; i <= last; ++i) {
+            _cells[i] = indexDocument(sourceModel(), i);
+        }
+
+        if (!_columns.empty())
+            emit dataChanged(index(first, 0, QModelIndex()), index(last, _columns.size() - 1, QModelIndex()));
+    }
+
+    void BsonTableModelProxy::sourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last)
+    {
+        if (parent.isValid())
+            return;
+
+        beginRemoveRows(QModelIndex(), first, last);
+    }
+
+    void BsonTableModelProxy::sourceRowsRemoved(const QModelIndex &parent, int first, int last)
+    {
+        if (parent.isValid())
+            return;
+
+        // Cells of following rows are moved up with their documents,
+        // columns of removed documents are kept
+        if (first < _cells.size())
+            _cells.erase(_cells.begin() + first, _cells.begin() + std::min<size_t>(last + 1, _cells.size()));
+        endRemoveRows();
+    }
+
+    void BsonTableModelProxy::fetchDocument(QAbstractItemModel *model, int row)
+    {
+        // Columns are fields of documents, so fields of all documents are needed
+        QModelIndex index = model->index(row, 0);
+        if (model->canFetchMore(index))
+            model->fetchMore(index);
+    }
+
+    BsonTableModelProxy::ColumnRowsType BsonTableModelProxy::indexDocument(QAbstractItemModel *model, int row) const
+    {
+        ColumnRowsType rows;
+        BsonTreeItem *node = QtUtils::item<BsonTreeItem *>(model->index(row, 0));
+        if (!node)
+            return rows;
+
+        int count = node->childrenCount();
+        for (int i = 0; i < count; ++i) {
+            size_t col = findIndexColumn(node->child(i)->key());
+            if (col == _columns.size())
+                continue;
+
+            if (rows.size() <= col)
+                rows.resize(col + 1, -1);
+
+            // The first of duplicated fields is shown
+            if (rows[col] < 0)
+                rows[col] = i;
+        }
+
+        return rows;
+    }
+
+    BsonTreeItem *BsonTableModelProxy::cell(BsonTreeItem *node, int row, int col) const
+    {
+        if (row < 0 || row >= _cells.size())
+            return NULL;
+
+        const ColumnRowsType &rows = _cells[row];
+        if (col >= rows.size() || rows[col] < 0)
+            return NULL;
+
+        return node->child(rows[col]);
+    }
+
     QVariant BsonTableModelProxy::data(const QModelIndex &index, int role) const
     {
         QVariant result;
@@ -120,12 +252,13 @@ namespace Robomongo
         }
 
         if (role == Qt::DisplayRole || role == Qt::ToolTipRole) {
+            QString value = node->value();
             bool isCut = node->type() == mongo::String ||  node->type() == mongo::Code || node->type() == mongo::CodeWScope;  
             if (role == Qt::ToolTipRole) {
-                result = isCut ? node->value() : node->value().left(500); 
+                result = isCut ? value : value.left(500); 
             }
             else{
-                result = isCut ? node->value() : node->value().simplified().left(300); 
+                result = isCut ? value : value.simplified().left(300); 
             }
         }
         else if (role == Qt::DecorationRole) {
@@ -154,18 +287,18 @@ namespace Robomongo
 
     size_t BsonTableModelProxy::findIndexColumn(const QString &col) const
     {
-        for (int i = 0; i < _columns.size(); ++i) {
-            if (_columns[i] == col) {
-                return i;
-            }
-        }
-        return _columns.size();
+        QHash<QString, int>::const_iterator it = _columnIndexes.constFind(col);
+        if (it == _columnIndexes.constEnd())
+            return _columns.size();
+
+        return it.value();
     }
 
     size_t BsonTableModelProxy::addColumn(const QString &col)
     {
         size_t column = findIndexColumn(col);
         if (column == _columns.size()) {
+            _columnIndexes.insert(col, _columns.size());
             _columns.push_back(col);
         }
         return column;
@@ -2,6 +2,7 @@
 #include <vector>
 
 #include <QAbstractProxyModel>
+#include <QHash>
 
 namespace Robomongo
 {
@@ -14,6 +15,7 @@ namespace Robomongo
     public:
         typedef QAbstractProxyModel BaseClass;
         typedef std::vector<QString> ColumnsValuesType;
+        typedef std::vector<int> ColumnRowsType;   // column -> row of field in document, -1 if absent
 
         explicit BsonTableModelProxy(QObject *parent = 0);
         QVariant data(const QModelIndex &index, int role) const;
@@ -28,12 +30,37 @@ namespace Robomongo
         virtual void setSourceModel( QAbstractItemModel* model );
         virtual QModelIndex parent( const QModelIndex& index ) const;
         virtual QModelIndex sibling(int row, int column, const QModelIndex &idx) const;
+
+    private Q_SLOTS:
+        void sourceRowsAboutToBeInserted(const QModelIndex &parent, int first, int last);
+        void sourceRowsInserted(const QModelIndex &parent, int first, int last);
+        void sourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+        void sourceRowsRemoved(const QModelIndex &parent, int first, int last);
+
     private:
+        /**
+         * @brief Parses fields of document in 'row' of source model
+         */
+        void fetchDocument(QAbstractItemModel *model, int row);
+
+        /**
+         * @brief Maps columns to fields of document in 'row' of source model.
+         * Columns of all its fields should be added before.
+         */
+        ColumnRowsType indexDocument(QAbstractItemModel *model, int row) const;
+
+        /**
+         * @brief Field of document 'node' in 'row' shown in column 'col', or NULL
+         */
+        BsonTreeItem *cell(BsonTreeItem *node, int row, int col) const;
+
         QString column(int col) const;
         size_t addColumn(const QString &col);
         size_t findIndexColumn(const QString &col) const;
 
         ColumnsValuesType _columns;
+        QHash<QString, int> _columnIndexes;     // key -> column
+        std::vector<ColumnRowsType> _cells;     // per row of source model
         BsonTreeItem *_root;
     };
 }
@@ -1,74 +1,81 @@
 #include "robomongo/gui/widgets/workarea/BsonTreeItem.h"
 #include <mongo/client/dbclientinterface.h>
 
-using namespace mongo;
+#include "robomongo/core/settings/SettingsManager.h"
+#include "robomongo/core/utils/BsonUtils.h"
+#include "robomongo/core/utils/QtUtils.h"
+#include "robomongo/core/AppRegistry.h"
+
 namespace
 {
-    struct removeIfFound : public std::unary_function<const Robomongo::BsonTreeItem*, bool> 
-    {
-        removeIfFound(Robomongo::BsonTreeItem *item) :_whatSearch(item) {}
-        bool operator()(const Robomongo::BsonTreeItem* item) const
-        {
-            if (item == _whatSearch) {
-                delete _whatSearch;
-                return true;
-            }
-            return false;
-        }
-        const Robomongo::BsonTreeItem *const _whatSearch;
-    };
+    QString arrayValue(int itemsCount) {
+        QString elements = itemsCount == 1 ? "element" : "elements";
+        return QString("[ %1 %2 ]").arg(itemsCount).arg(elements);
+    }
 
-    const Robomongo::BsonTreeItem *findSuperRoot(const Robomongo::BsonTreeItem *const item)
-    {
-        Robomongo::BsonTreeItem *parent = qobject_cast<Robomongo::BsonTreeItem *>(item->parent());
-        if (parent) {
-            Robomongo::BsonTreeItem *grParent = qobject_cast<Robomongo::BsonTreeItem *>(parent->parent());
-            if (grParent) {
-               return findSuperRoot(parent);
-            }
-        }
-        return item;
+    QString objectValue(int itemsCount) {
+        QString fields = itemsCount == 1 ? "field" : "fields";
+        return QString("{ %1 %2 }").arg(itemsCount).arg(fields);
     }
 }
+
 namespace Robomongo
 {
-    BsonTreeItem::BsonTreeItem(QObject *parent) 
-        :BaseClass(parent)
+    BsonTreeItem::BsonTreeItem(BsonTreeArena *arena, int index, int parent, int row, int document, int offset,
+                               mongo::BSONType type, mongo::BinDataType binType) :
+        _arena(arena),
+        _index(index),
+        _parent(parent),
+        _row(row),
+        _firstChild(-1),
+        _childrenCount(-1),
+        _elementsCount(-1),
+        _document(document),
+        _offset(offset),
+        _type(static_cast<signed char>(type)),
+        _binType(static_cast<unsigned char>(binType))
     {
-       
     }
 
-    BsonTreeItem::BsonTreeItem(const mongo::BSONObj &bsonObjRoot, QObject *parent)
-        :BaseClass(parent),
-        _root(bsonObjRoot)
+    BsonTreeItem *BsonTreeItem::parent() const
     {
+        if (_parent < 0)
+            return NULL;
 
+        return _arena->item(_parent);
     }
 
     unsigned BsonTreeItem::childrenCount() const
     {
-        return _items.size();
-    }
+        if (_parent < 0)
+            return _arena->_documentItems.size();
 
-    void BsonTreeItem::clear()
-    {
-        _items.clear();
+        return _childrenCount < 0 ? 0 : _childrenCount;
     }
 
-    void BsonTreeItem::addChild(BsonTreeItem *item)
+    int BsonTreeItem::elementsCount() const
     {
-        _items.push_back(item);
+        if (_parent < 0 || _childrenCount >= 0)
+            return childrenCount();
+
+        if (_elementsCount < 0)
+            _elementsCount = BsonUtils::isDocument(type()) ? BsonUtils::elementsCount(object()) : 0;
+
+        return _elementsCount;
     }
 
     BsonTreeItem* BsonTreeItem::child(unsigned pos) const
     {
-        return _items[pos];
+        if (_parent < 0)
+            return _arena->item(_arena->_documentItems[pos]);
+
+        return _arena->item(_firstChild + pos);
     }
 
     BsonTreeItem* BsonTreeItem::childSafe(unsigned pos) const
     {
         if (childrenCount() > pos) {
-            return _items[pos];
+            return child(pos);
         }
         else {
             return NULL;
@@ -77,81 +84,178 @@ namespace Robomongo
 
     BsonTreeItem* BsonTreeItem::childByKey(const QString &val)
     {
-        for (unsigned i = 0; i < _items.size(); ++i) {
-            if (_items[i]->key() == val) {
-                return _items[i];
-            }
-        }
-        return NULL;
+        return _arena->childByKey(this, val);
+    }
+
+    int BsonTreeItem::indexOf(BsonTreeItem *item) const
+    {
+        if (item->_parent != _index)
+            return -1;
+
+        return item->_row;
     }
 
     const BsonTreeItem *BsonTreeItem::superParent() const
     {
-        return findSuperRoot(this);
+        const BsonTreeItem *item = this;
+        while (item->_parent > 0)
+            item = item->parent();
+        return item;
     }
 
     mongo::BSONObj BsonTreeItem::superRoot() const
     {
-        return superParent()->root();
+        if (_document < 0)
+            return mongo::BSONObj();
+
+        return _arena->_documents[_document];
     }
 
     mongo::BSONObj BsonTreeItem::root() const
     {
-        return _root;
+        if (_offset < 0)
+            return superRoot();
+
+        return parent()->object();
     }
 
-    int BsonTreeItem::indexOf(BsonTreeItem *item) const
+    mongo::BSONObj BsonTreeItem::object() const
     {
-        for (unsigned i = 0; i < _items.size(); ++i) {
-            if (item == _items[i]) {
-                return i;
-            }
-        }
-        return -1;
+        if (_offset < 0)
+            return superRoot();
+
+        return element().Obj();
     }
 
-    QString BsonTreeItem::key() const
+    mongo::BSONElement BsonTreeItem::element() const
     {
-        return _fields._key;
+        if (_offset < 0)
+            return mongo::BSONElement();
+
+        return mongo::BSONElement(_arena->_documents[_document].objdata() + _offset);
     }
 
-    QString BsonTreeItem::value() const
+    std::string BsonTreeItem::fieldName() const
+    {
+        if (_offset < 0)
+            return std::string();
+
+        return element().fieldName();
+    }
+
+    QString BsonTreeItem::key() const
     {
-        return _fields._value;
+        if (_offset < 0)
+            return QString();
+
+        QString name = QtUtils::toQString(fieldName());
+
+        // When we iterate array, show field names in square brackets
+        // In this case field names are numeric, starting from 0.
+        if (parent()->type() == mongo::Array)
+            return "[" + name + "]";
+
+        return name;
     }
 
-    mongo::BSONType BsonTreeItem::type() const
+    QString BsonTreeItem::value() const
     {
-        return _fields._type;
+        if (!BsonUtils::isDocument(type()))
+            return buildValue(element());
+
+        int count = elementsCount();
+        return type() == mongo::Array ? arrayValue(count) : objectValue(count);
     }
 
-    void BsonTreeItem::setKey(const QString &key)
+    QString BsonTreeItem::buildValue(const mongo::BSONElement &element)
     {
-        _fields._key = key;
+        if (BsonUtils::isArray(element))
+            return arrayValue(BsonUtils::elementsCount(element.Obj()));
+
+        if (BsonUtils::isDocument(element))
+            return objectValue(BsonUtils::elementsCount(element.Obj()));
+
+        std::string result;
+        BsonUtils::buildJsonString(element, result, AppRegistry::instance().settingsManager()->uuidEncoding(),
+                                   AppRegistry::instance().settingsManager()->timeZone());
+        return QtUtils::toQString(result);
     }
 
-    void BsonTreeItem::setValue(const QString &value)
+    BsonTreeArena::BsonTreeArena()
     {
-        _fields._value = value;
+        BsonTreeItem root(this, 0, -1, 0, -1, -1, mongo::Object, mongo::BinDataGeneral);
+        root._childrenCount = 0;
+        _items.push_back(root);
     }
 
-    void BsonTreeItem::setType(mongo::BSONType type)
+    BsonTreeItem *BsonTreeArena::addDocument(const mongo::BSONObj &document)
     {
-       _fields._type = type;
+        int index = _items.size();
+        int row = _documentItems.size();
+        _documents.push_back(document);
+        _items.push_back(BsonTreeItem(this, index, 0, row, _documents.size() - 1, -1,
+                                      document.isArray() ? mongo::Array : mongo::Object, mongo::BinDataGeneral));
+        _documentItems.push_back(index);
+        return &_items.back();
     }
 
-    mongo::BinDataType BsonTreeItem::binType() const
+    void BsonTreeArena::removeDocument(BsonTreeItem *item)
     {
-        return _fields._binType;
+        int row = item->_row;
+        _documentItems.erase(_documentItems.begin() + row);
+        for (size_t i = row; i < _documentItems.size(); ++i)
+            _items[_documentItems[i]]._row = i;
+
+        _documents[item->_document] = mongo::BSONObj();
+        _keyIndexes.remove(item->_index);
     }
 
-    void BsonTreeItem::setBinType(mongo::BinDataType type)
+    int BsonTreeArena::fetchChildren(BsonTreeItem *item)
     {
-        _fields._binType = type;
+        if (item->isFetched())
+            return item->_childrenCount;
+
+        mongo::BSONObj obj = item->object();
+        const char *buffer = _documents[item->_document].objdata();
+
+        int first = _items.size();
+        int row = 0;
+        mongo::BSONObjIterator iterator(obj);
+        while (iterator.more()) {
+            mongo::BSONElement element = iterator.next();
+            mongo::BinDataType binType = element.type() == mongo::BinData ? element.binDataType() : mongo::BinDataGeneral;
+            _items.push_back(BsonTreeItem(this, first + row, item->_index, row, item->_document,
+                                          element.rawdata() - buffer, element.type(), binType));
+            ++row;
+        }
+
+        item->_firstChild = first;
+        item->_childrenCount = row;
+        return row;
     }
 
-    void BsonTreeItem::removeChild(BsonTreeItem *item)
+    BsonTreeItem *BsonTreeArena::childByKey(const BsonTreeItem *item, const QString &key)
     {
-        _items.erase(std::remove_if(_items.begin(), _items.end(), removeIfFound(item)), _items.end());
+        if (!item->isFetched() || item->_parent < 0)
+            return NULL;
+
+        QHash<int, KeyIndexType>::iterator it = _keyIndexes.find(item->_index);
+        if (it == _keyIndexes.end()) {
+            KeyIndexType index;
+            index.reserve(item->_childrenCount);
+            for (int i = 0; i < item->_childrenCount; ++i) {
+                // Keep the first of duplicated fields, as linear search did
+                QString childKey = _items[item->_firstChild + i].key();
+                if (!index.contains(childKey))
+                    index.insert(childKey, i);
+            }
+            it = _keyIndexes.insert(item->_index, index);
+        }
+
+        KeyIndexType::const_iterator row = it->constFind(key);
+        if (row == it->constEnd())
+            return NULL;
+
+        return &_items[item->_firstChild + row.value()];
     }
 }
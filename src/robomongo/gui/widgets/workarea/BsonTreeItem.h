@@ -1,26 +1,27 @@
 #pragma once
 
+#include <deque>
 #include <vector>
-#include <QObject>
+#include <QString>
+#include <QHash>
 #include <mongo/bson/bsonobj.h>
 #include <mongo/bson/bsonelement.h>
 
 namespace Robomongo
 {
+    class BsonTreeArena;
+
     /**
-     * @brief BSON tree item (represents array or object)
+     * @brief BSON tree item (document, or field of document or array).
+     *
+     *        Items are small values stored in BsonTreeArena. Item does not
+     *        copy its value, it keeps offset of its element in the buffer of
+     *        document, that is owned by the arena. Parent and children are
+     *        referenced by positions in the arena, children of item are
+     *        stored one after another.
      */
-    struct BsonItemFields
-    {
-        QString _key;
-        QString _value;
-        mongo::BSONType _type;
-        mongo::BinDataType _binType;
-    };
-
-    class BsonTreeItem : public QObject
+    class BsonTreeItem
     {
-        Q_OBJECT
     public:
         enum eColumn
         {
@@ -30,45 +31,128 @@ namespace Robomongo
             eCountColumns = 3
         };
 
-        typedef QObject BaseClass;
-        typedef std::vector<BsonTreeItem*> ChildContainerType;
-
-        explicit BsonTreeItem(QObject *parent = 0);
-        explicit BsonTreeItem(const mongo::BSONObj &bsonObjRoot, QObject *parent = 0);
+        /**
+         * @return NULL for the root item of model
+         */
+        BsonTreeItem *parent() const;
 
+        /**
+         * @brief Number of children, 0 until they are created by BsonTreeArena::fetchChildren()
+         */
         unsigned childrenCount() const;
-        void clear();
-        void addChild(BsonTreeItem *item);
-        void removeChild(BsonTreeItem *item);
+        bool isFetched() const { return _childrenCount >= 0; }
+
+        /**
+         * @brief Number of fields of document or array of this item. Unlike
+         * childrenCount(), it is known before children are created. Counted
+         * once and cached in the item.
+         */
+        int elementsCount() const;
         BsonTreeItem* child(unsigned pos) const;
         BsonTreeItem* childSafe(unsigned pos) const;
+
+        /**
+         * @brief Child with key() equal to 'val'. Index of keys is built
+         * by the arena on the first lookup.
+         */
         BsonTreeItem* childByKey(const QString &val);
         int indexOf(BsonTreeItem *item) const;
+        int row() const { return _row; }
 
         const BsonTreeItem* superParent() const;
+
+        /**
+         * @brief Document or array that contains this item. For items of documents,
+         * this is the document itself.
+         */
         mongo::BSONObj root() const;
         mongo::BSONObj superRoot() const;
 
-        std::string fieldName() const { return _fieldName; };
-        void setFieldName(const std::string &fieldName) { _fieldName = fieldName; };
+        /**
+         * @brief Document or array of this item, for items of Object or Array type
+         */
+        mongo::BSONObj object() const;
 
+        std::string fieldName() const;
         QString key() const;
-        void setKey(const QString &key);
 
+        /**
+         * @brief Element of this item in root(). Items of documents
+         * (top-level items) have no element, their root() is the document.
+         */
+        mongo::BSONElement element() const;
+
+        /**
+         * @brief Text of "Value" column. It is formatted on every call,
+         * model caches it for visible rows.
+         */
         QString value() const;
-        void setValue(const QString &value);
+        static QString buildValue(const mongo::BSONElement &element);
+
+        mongo::BSONType type() const { return static_cast<mongo::BSONType>(_type); }
+        mongo::BinDataType binType() const { return static_cast<mongo::BinDataType>(_binType); }
+
+    private:
+        friend class BsonTreeArena;
+
+        BsonTreeItem(BsonTreeArena *arena, int index, int parent, int row, int document, int offset,
+                     mongo::BSONType type, mongo::BinDataType binType);
+
+        BsonTreeArena *_arena;
+        int _index;             // position of this item in arena
+        int _parent;            // -1 for the root item
+        int _row;
+        int _firstChild;
+        int _childrenCount;     // -1 until children are created
+        mutable int _elementsCount; // -1 until counted
+        int _document;          // document that contains this item, -1 for the root item
+        int _offset;            // offset of element in document, -1 for items of documents
+        signed char _type;
+        unsigned char _binType;
+    };
+
+    /**
+     * @brief Storage of BsonTreeItem's of one model. Items are appended and
+     *        never moved, so pointers to them stay valid (they are used as
+     *        internal pointers of QModelIndex) while the arena is alive.
+     */
+    class BsonTreeArena
+    {
+    public:
+        BsonTreeArena();
+
+        /**
+         * @brief Root item, children of root are documents
+         */
+        BsonTreeItem *root() { return &_items.front(); }
+        BsonTreeItem *item(int index) { return &_items[index]; }
+
+        BsonTreeItem *addDocument(const mongo::BSONObj &document);
+
+        /**
+         * @brief Removes item of document from root. Items of its fields are
+         * not reused, but the buffer of document is released.
+         */
+        void removeDocument(BsonTreeItem *item);
 
-        mongo::BSONType type() const;
-        void setType(mongo::BSONType type);
+        /**
+         * @brief Creates children of item of Object or Array type
+         * @return number of children
+         */
+        int fetchChildren(BsonTreeItem *item);
 
-        mongo::BinDataType binType() const;
-        void setBinType(mongo::BinDataType type);
+        /**
+         * @brief Child of fetched item with given key, or NULL
+         */
+        BsonTreeItem *childByKey(const BsonTreeItem *item, const QString &key);
 
-    protected:
+    private:
+        friend class BsonTreeItem;
+        typedef QHash<QString, int> KeyIndexType;   // key -> row of child
 
-        const mongo::BSONObj _root;
-        ChildContainerType _items;
-        BsonItemFields _fields;
-        std::string _fieldName;
+        std::deque<BsonTreeItem> _items;
+        std::vector<mongo::BSONObj> _documents;
+        std::vector<int> _documentItems;        // children of the root item
+        QHash<int, KeyIndexType> _keyIndexes;   // item index -> keys of its children
     };
 }
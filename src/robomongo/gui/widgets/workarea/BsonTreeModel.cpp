@@ -9,110 +9,57 @@
 #include "robomongo/core/utils/QtUtils.h"
 #include "robomongo/gui/GuiRegistry.h"
 
-namespace
-{
-    using namespace Robomongo;
-
-    QString arrayValue(int itemsCount) {
-        QString elements = itemsCount == 1 ? "element" : "elements";
-        return QString("[ %1 %2 ]").arg(itemsCount).arg(elements);
-    }
-
-    QString objectValue(int itemsCount) {
-        QString fields = itemsCount == 1 ? "field" : "fields";
-        return QString("{ %1 %2 }").arg(itemsCount).arg(fields);
-    }
-
-    void parseDocument(BsonTreeItem *root, const mongo::BSONObj &doc, bool isArray)
-    {            
-            mongo::BSONObjIterator iterator(doc);
-            while (iterator.more())
-            {
-                mongo::BSONElement element = iterator.next();                
-                BsonTreeItem *childItemInner = new BsonTreeItem(doc, root);
-                std::string fieldName = std::string(element.fieldName());
-                childItemInner->setFieldName(fieldName);
-
-                QString uiFieldName = QtUtils::toQString(fieldName);
-                childItemInner->setKey(uiFieldName);
-
-                if (isArray) {
-                    // When we iterate array, show field names in square brackets
-                    // In this case field names are numeric, starting from 0.
-                    childItemInner->setKey("[" + uiFieldName + "]");
-                }
-
-                if (BsonUtils::isArray(element)) {
-                    int itemsCount = element.Array().size();
-                    childItemInner->setValue(arrayValue(itemsCount));
-                }
-                else if (BsonUtils::isDocument(element)) {
-                    int count = BsonUtils::elementsCount(element.Obj());
-                    childItemInner->setValue(objectValue(count));
-                }
-                else {
-                    std::string result;
-                    BsonUtils::buildJsonString(element, result, AppRegistry::instance().settingsManager()->uuidEncoding(), AppRegistry::instance().settingsManager()->timeZone());
-                    childItemInner->setValue(QtUtils::toQString(result));
-                }
-                childItemInner->setType(element.type());
-                if (element.type() == mongo::BinData) {
-                    childItemInner->setBinType(element.binDataType());
-                }
-                root->addChild(childItemInner);
-                //root->setValue(QString("{ %1 fields }").arg(root->childrenCount()));
-            }            
-    }
-}
-
 namespace Robomongo
 {
     BsonTreeModel::BsonTreeModel(const std::vector<MongoDocumentPtr> &documents, QObject *parent) :
         BaseClass(parent),
-        _root(new BsonTreeItem(this))
+        _root(_arena.root())
     {
-        for (int i = 0; i < documents.size(); ++i) {
-            MongoDocumentPtr doc = documents[i]; 
-            BsonTreeItem *child = new BsonTreeItem(doc->bsonObj(), _root);
-            parseDocument(child, doc->bsonObj(), doc->bsonObj().isArray());
-
-            QString idValue;
-            BsonTreeItem *idItem = child->childByKey("_id");
-            if (idItem) {
-                idValue = idItem->value();
-            }
+        _keys.setMaxCost(displayCacheSize);
+        _values.setMaxCost(displayCacheSize);
+        addDocuments(documents);
+    }
 
-            child->setKey(QString("(%1) %2").arg(i + 1).arg(idValue));
+    void BsonTreeModel::appendDocuments(const std::vector<MongoDocumentPtr> &documents)
+    {
+        if (documents.empty())
+            return;
 
-            int count = BsonUtils::elementsCount(doc->bsonObj());
+        int first = _root->childrenCount();
+        beginInsertRows(QModelIndex(), first, first + documents.size() - 1);
+        addDocuments(documents);
+        endInsertRows();
+    }
 
-            if (doc->bsonObj().isArray()) {
-                child->setValue(arrayValue(count));
-                child->setType(mongo::Array);
-            } else {
-                child->setValue(objectValue(count));
-                child->setType(mongo::Object);
-            }
-            _root->addChild(child);
+    void BsonTreeModel::addDocuments(const std::vector<MongoDocumentPtr> &documents)
+    {
+        // Fields of documents are parsed in fetchMore(), when document is expanded
+        for (int i = 0; i < documents.size(); ++i) {
+            _arena.addDocument(documents[i]->bsonObj());
         }
     }
 
     void BsonTreeModel::fetchMore(const QModelIndex &parent)
     {
         BsonTreeItem *node = QtUtils::item<BsonTreeItem*>(parent);
-        if (node) {
-            mongo::BSONElement elem = BsonUtils::indexOf(node->root(), parent.row());
-            if (!elem.isNull() && elem.isABSONObj()) {
-                parseDocument(node, elem.Obj(), elem.type() == mongo::Array);
-            }            
+        if (!node || node->isFetched() || !BsonUtils::isDocument(node->type()))
+            return;
+
+        int count = node->elementsCount();
+        if (!count) {
+            _arena.fetchChildren(node);
+            return;
         }
-        return BaseClass::fetchMore(parent);
+
+        beginInsertRows(parent, 0, count - 1);
+        _arena.fetchChildren(node);
+        endInsertRows();
     }
 
     bool BsonTreeModel::canFetchMore(const QModelIndex &parent) const
     {
         BsonTreeItem *node = QtUtils::item<BsonTreeItem*>(parent);
-        if (node && !node->childrenCount()) {
+        if (node && !node->isFetched()) {
             return BsonUtils::isDocument(node->type());
         }
         return false;
@@ -176,16 +123,17 @@ namespace Robomongo
         if (role == Qt::DisplayRole || role == Qt::ToolTipRole) {
             if (col == BsonTreeItem::eKey) {
                 if (role == Qt::DisplayRole) {
-                    result = node->key();
+                    result = node->parent() == _root ? documentKey(node, index.row()) : node->key();
                 }
             }
             else if (col == BsonTreeItem::eValue) {
+                QString value = displayValue(node);
                 bool isCut = node->type() == mongo::String ||  node->type() == mongo::Code || node->type() == mongo::CodeWScope;  
                 if (role == Qt::ToolTipRole) {
-                    result = isCut ? node->value().left(500) : node->value(); 
+                    result = isCut ? value.left(500) : value; 
                 }
                 else{
-                    result = isCut ? node->value().simplified().left(300) : node->value(); 
+                    result = isCut ? value.simplified().left(300) : value; 
                 }
             }
             else if (col == BsonTreeItem::eType) {
@@ -196,6 +144,31 @@ namespace Robomongo
         return result;
     }
 
+    QString BsonTreeModel::documentKey(BsonTreeItem *item, int row) const
+    {
+        if (QString *key = _keys.object(item))
+            return *key;
+
+        QString idValue;
+        mongo::BSONElement id = item->root().getField("_id");
+        if (!id.eoo())
+            idValue = BsonTreeItem::buildValue(id);
+
+        QString key = QString("(%1) %2").arg(row + 1).arg(idValue);
+        _keys.insert(item, new QString(key));
+        return key;
+    }
+
+    QString BsonTreeModel::displayValue(BsonTreeItem *item) const
+    {
+        if (QString *value = _values.object(item))
+            return *value;
+
+        QString value = item->value();
+        _values.insert(item, new QString(value));
+        return value;
+    }
+
     Qt::ItemFlags BsonTreeModel::flags(const QModelIndex &index) const
     {
         Qt::ItemFlags result = 0;
@@ -246,11 +219,9 @@ namespace Robomongo
         QModelIndex result;
         if (index.isValid()) {
             BsonTreeItem *const childItem = QtUtils::item<BsonTreeItem*const>(index);
-            BsonTreeItem *const parentItem = static_cast<BsonTreeItem*const>(childItem->parent());
+            BsonTreeItem *const parentItem = childItem->parent();
             if (parentItem && parentItem != _root) {
-                BsonTreeItem *const grandParent = static_cast<BsonTreeItem*const>(parentItem->parent());
-                int row = grandParent->indexOf(parentItem);
-                result = createIndex(row, 0, parentItem);
+                result = createIndex(parentItem->row(), 0, parentItem);
             }
         }
         return result;
@@ -275,24 +246,18 @@ namespace Robomongo
         return index;
     }
 
-    void BsonTreeModel::insertItem(BsonTreeItem *parent, BsonTreeItem *children)
-    {
-        QModelIndex index = createIndex(0, 0, parent);
-        unsigned child_count = parent->childrenCount();
-        beginInsertRows(index, child_count, child_count);
-        parent->addChild(children);
-        endInsertRows();
-    }
-
     void BsonTreeModel::removeitem(BsonTreeItem *children)
     {
-        BsonTreeItem *parent = static_cast<BsonTreeItem *>(children->parent());
-        if (parent) {
-            QModelIndex index = createIndex(0, 0, parent);
-            int row = parent->indexOf(children);
-            beginRemoveRows(index, row, row);
-            parent->removeChild(children);
-            endRemoveRows();
-        }
+        if (children->parent() != _root)
+            return;
+
+        int row = children->row();
+        beginRemoveRows(QModelIndex(), row, row);
+        _arena.removeDocument(children);
+
+        // Keys of documents include their row numbers
+        _keys.clear();
+        _values.remove(children);
+        endRemoveRows();
     }
 }
@@ -1,18 +1,25 @@
 #pragma once
 #include <vector>
 #include <QAbstractItemModel>
+#include <QCache>
 #include "robomongo/core/Core.h"
+#include "robomongo/gui/widgets/workarea/BsonTreeItem.h"
 
 namespace Robomongo
 {
-    class BsonTreeItem;
-
     class BsonTreeModel : public QAbstractItemModel
     {
         Q_OBJECT
 
     public:
         typedef QAbstractItemModel BaseClass;
+
+        /**
+         * @brief Number of formatted keys and values, that are kept
+         * for rows shown recently
+         */
+        enum { displayCacheSize = 1000 };
+
         static const QIcon &getIcon(BsonTreeItem *item);
         explicit BsonTreeModel(const std::vector<MongoDocumentPtr> &documents, QObject *parent = 0);
         QVariant data(const QModelIndex &index, int role) const;
@@ -25,13 +32,35 @@ namespace Robomongo
         virtual QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const;
         virtual QModelIndex parent(const QModelIndex& index) const;
 
-        void insertItem(BsonTreeItem *parent, BsonTreeItem *children);
+        /**
+         * @brief Adds top-level rows for documents received after model creation
+         */
+        void appendDocuments(const std::vector<MongoDocumentPtr> &documents);
+
+        /**
+         * @brief Removes top-level row of document
+         */
         void removeitem(BsonTreeItem *children);
 
         virtual void fetchMore(const QModelIndex &parent);
         virtual bool canFetchMore(const QModelIndex &parent) const;
         virtual bool hasChildren(const QModelIndex &parent = QModelIndex()) const;
     protected:
+        /**
+         * @brief Creates items of documents only. Fields of document
+         * are parsed by fetchMore(), when it is expanded.
+         */
+        void addDocuments(const std::vector<MongoDocumentPtr> &documents);
+
+        /**
+         * @brief Key of document: its number and _id
+         */
+        QString documentKey(BsonTreeItem *item, int row) const;
+        QString displayValue(BsonTreeItem *item) const;
+
+        BsonTreeArena _arena;
         BsonTreeItem *const _root;
+        mutable QCache<BsonTreeItem *, QString> _keys;
+        mutable QCache<BsonTreeItem *, QString> _values;
     };
 }
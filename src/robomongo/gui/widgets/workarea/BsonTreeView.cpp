@@ -109,6 +109,11 @@ namespace Robomongo
     {
         if (index.isValid()) {
             BaseClass::expand(index);
+
+            // Fields of item are parsed on demand
+            if (model()->canFetchMore(index))
+                model()->fetchMore(index);
+
             BsonTreeItem *item = QtUtils::item<BsonTreeItem*>(index);
             for (unsigned i = 0; i < item->childrenCount(); ++i) {
                 BsonTreeItem *tritem = item->child(i);
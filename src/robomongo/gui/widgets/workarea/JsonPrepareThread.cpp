@@ -1,18 +1,24 @@
 #include "robomongo/gui/widgets/workarea/JsonPrepareThread.h"
 
-#include <QHBoxLayout>
+#include <algorithm>
+#include <QThreadPool>
+#include <QElapsedTimer>
 
 #include "robomongo/core/domain/MongoDocument.h"
-#include "robomongo/core/utils/BsonUtils.h"
+#include "robomongo/core/utils/JsonWriter.h"
 #include "robomongo/core/utils/QtUtils.h"
 
 namespace Robomongo
 {
-    JsonPrepareThread::JsonPrepareThread(const std::vector<MongoDocumentPtr> &bsonObjects, UUIDEncoding uuidEncoding, SupportedTimes timeZone)
+    JsonPrepareThread::JsonPrepareThread(const std::vector<MongoDocumentPtr> &bsonObjects, UUIDEncoding uuidEncoding, SupportedTimes timeZone,
+                                         int startPosition, Mode mode)
         :_bsonObjects(bsonObjects),
         _uuidEncoding(uuidEncoding),
         _timeZone(timeZone),
-        _stop(false)
+        _startPosition(startPosition),
+        _mode(mode),
+        _stop(false),
+        _partSlot(1)
     {
     }
 
@@ -21,35 +27,166 @@ namespace Robomongo
         _stop = true;
     }
 
+    void JsonPrepareThread::partProcessed()
+    {
+        _partSlot.release();
+    }
+
+    /*
+    ** Task of thread pool, that formats one chunk of documents
+    */
+    class JsonChunkTask : public QRunnable
+    {
+    public:
+        JsonChunkTask(JsonPrepareThread *thread, size_t chunk) : _thread(thread), _chunk(chunk) {}
+        virtual void run() { _thread->formatChunk(_chunk); }
+
+    private:
+        JsonPrepareThread *const _thread;
+        const size_t _chunk;
+    };
+
     void JsonPrepareThread::run()
     {
-        int position = 1; // 1-based numbering to match tree & table views
-        for (std::vector<MongoDocumentPtr>::const_iterator it = _bsonObjects.begin(); it != _bsonObjects.end(); ++it)
-        {
-            MongoDocumentPtr doc = *it;
-            mongo::StringBuilder sb;
-            if (position == 1)
-                sb << "/* 1 */\n";
-            else
-                sb << "\n\n/* " << position << " */\n";
+        const size_t chunksCount = (_bsonObjects.size() + chunkSize - 1) / chunkSize;
+        _chunks.assign(chunksCount, std::vector<QString>());
+        _chunkLines.assign(chunksCount, QVector<int>());
+        _readyChunks.assign(chunksCount, false);
 
-            mongo::BSONObj obj = doc->bsonObj();
-            std::string stdJson = BsonUtils::jsonString(obj, mongo::TenGen, 1, _uuidEncoding, _timeZone);
+        // Number of chunks, that are formatted ahead of emitted ones, is limited
+        // to keep memory bounded when GUI thread is slower than formatting.
+        // Pool is shared by all threads, so several results do not create more threads than cores
+        QThreadPool *pool = QThreadPool::globalInstance();
+        const size_t window = chunksCount > 1 ? pool->maxThreadCount() * 2 : 0;
+        size_t submitted = 0;
+        for (; submitted < chunksCount && submitted < window; ++submitted)
+            pool->start(new JsonChunkTask(this, submitted));
 
-            if (_stop)
-                break;
+        std::vector<QString> parts;
+        QVector<int> lines;
+        QString pending;
+        QElapsedTimer sinceEmit;
+        sinceEmit.start();
+        for (size_t chunk = 0; chunk < chunksCount && !_stop; ++chunk)
+        {
+            // Single chunk is formatted in this thread
+            if (!window)
+                formatChunk(chunk);
 
-            sb << stdJson;
-            QString json = QtUtils::toQString(sb.str());
+            takeChunk(chunk, parts, lines);
 
-            if (_stop)
-                break;
+            if (submitted < chunksCount)
+                pool->start(new JsonChunkTask(this, submitted++));
 
-            emit partReady(json);
+            if (_mode == CountLines) {
+                if (!_stop)
+                    emit linesCounted(_startPosition - 1 + chunk * chunkSize, lines);
+                continue;
+            }
 
-            position++;
+            for (std::vector<QString>::const_iterator it = parts.begin(); it != parts.end() && !_stop; ++it)
+            {
+                pending += *it;
+                if (pending.size() < partSize && sinceEmit.elapsed() < partInterval)
+                    continue;
+
+                // While GUI is busy with previous part, documents are collected into the next one
+                if (emitPart(pending, pending.size() >= maxPendingSize)) {
+                    // Emitted string is shared with receiver, new one is started
+                    pending.clear();
+                    sinceEmit.restart();
+                }
+            }
         }
 
+        if (!_stop && !pending.isEmpty())
+            emitPart(pending, true);
+
+        // Running tasks see _stop and finish quickly, queued ones format nothing
+        waitForChunks(submitted);
         emit done();
     }
+
+    bool JsonPrepareThread::emitPart(const QString &part, bool wait)
+    {
+        if (!wait) {
+            if (!_partSlot.tryAcquire())
+                return false;
+        }
+        else {
+            // Receiver does not process parts of stopped thread
+            while (!_partSlot.tryAcquire(1, 50)) {
+                if (_stop)
+                    return false;
+            }
+        }
+
+        emit partReady(part);
+        return true;
+    }
+
+    void JsonPrepareThread::appendDocument(JsonWriter &writer, std::string &buffer, const MongoDocumentPtr &document, int position)
+    {
+        if (position == 1) {
+            buffer.append("/* 1 */\n");
+        }
+        else {
+            buffer.append("\n\n/* ");
+            buffer.append(QByteArray::number(position).constData());
+            buffer.append(" */\n");
+        }
+
+        writer.writeObject(document->bsonObj(), 1);
+    }
+
+    void JsonPrepareThread::formatChunk(size_t chunk)
+    {
+        std::vector<QString> parts;
+        QVector<int> lines;
+
+        // Buffer keeps its capacity, so it is allocated only for the first documents
+        std::string buffer;
+        JsonWriter writer(buffer, mongo::TenGen, _uuidEncoding, _timeZone);
+
+        const size_t first = chunk * chunkSize;
+        const size_t last = std::min(first + chunkSize, _bsonObjects.size());
+        for (size_t i = first; i < last && !_stop; ++i)
+        {
+            int position = _startPosition + i; // 1-based numbering to match tree & table views
+            buffer.clear();
+            appendDocument(writer, buffer, _bsonObjects[i], position);
+
+            if (_mode == CountLines)
+                lines.push_back(std::count(buffer.begin(), buffer.end(), '\n'));
+            else
+                parts.push_back(QtUtils::toQString(buffer));
+        }
+
+        QMutexLocker lock(&_mutex);
+        _chunks[chunk].swap(parts);
+        _chunkLines[chunk].swap(lines);
+        _readyChunks[chunk] = true;
+        _chunkReady.wakeAll();
+    }
+
+    void JsonPrepareThread::waitForChunks(size_t count)
+    {
+        QMutexLocker lock(&_mutex);
+        for (size_t chunk = 0; chunk < count; ++chunk) {
+            while (!_readyChunks[chunk])
+                _chunkReady.wait(&_mutex);
+        }
+    }
+
+    void JsonPrepareThread::takeChunk(size_t chunk, std::vector<QString> &parts, QVector<int> &lines)
+    {
+        QMutexLocker lock(&_mutex);
+        while (!_readyChunks[chunk])
+            _chunkReady.wait(&_mutex);
+
+        parts.clear();
+        parts.swap(_chunks[chunk]);
+        lines.clear();
+        lines.swap(_chunkLines[chunk]);
+    }
 }
@@ -1,6 +1,10 @@
 #pragma once
 
 #include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QSemaphore>
+#include <QVector>
 #include <vector>
 
 #include "robomongo/core/Core.h"
@@ -9,19 +13,58 @@
 
 namespace Robomongo
 {
+    class JsonWriter;
+
     /*
-    ** In this thread we are running task to prepare JSON string from list of BSON objects
+    ** In this thread we are running task to prepare JSON string from list of BSON objects.
+    ** Documents are formatted by chunks on the global thread pool, parts are emitted in order of documents.
     */
     class JsonPrepareThread : public QThread
     {
         Q_OBJECT
+        friend class JsonChunkTask;
 
     public:
+        /**
+         * @brief Number of documents formatted by one task of thread pool
+         */
+        enum { chunkSize = 64 };
+
+        /**
+         * @brief Documents are emitted together, until their text reaches
+         * partSize characters (256 KB) or partInterval ms pass since the previous part
+         */
+        enum { partSize = 128 * 1024, partInterval = 16 };
+
+        /**
+         * @brief Formatting waits for the GUI, when text of this size is not emitted yet
+         */
+        enum { maxPendingSize = 4 * partSize };
+
+        enum Mode
+        {
+            FormatText,     // emits partReady() with text of documents
+            CountLines      // emits linesCounted() with numbers of lines of documents
+        };
+
         /*
         ** Constructor
         */
-        JsonPrepareThread(const std::vector<MongoDocumentPtr> &bsonObjects, UUIDEncoding uuidEncoding, SupportedTimes timeZone);
+        JsonPrepareThread(const std::vector<MongoDocumentPtr> &bsonObjects, UUIDEncoding uuidEncoding, SupportedTimes timeZone,
+                          int startPosition = 1, Mode mode = FormatText);
         void stop();
+
+        /**
+         * @brief Appends text of document, as it is shown in Text view
+         * @param position: 1-based number of document
+         */
+        static void appendDocument(JsonWriter &writer, std::string &buffer, const MongoDocumentPtr &document, int position);
+
+        /**
+         * @brief Should be called by receiver of partReady(), when the part is shown.
+         * Next part is not emitted until then, so at most one part is queued.
+         */
+        void partProcessed();
    Q_SIGNALS:
         /**
          * @brief Signals when all parts prepared
@@ -29,10 +72,17 @@ namespace Robomongo
         void done();
 
         /**
-         * @brief Signals when json part is ready
+         * @brief Signals when json part (text of one or several documents) is ready.
+         * Receiver should call partProcessed() after it is shown.
          */
         void partReady(const QString &part);
 
+        /**
+         * @brief Signals numbers of lines ('\n' characters) in text of documents,
+         * starting from 0-based 'firstDocument', in CountLines mode
+         */
+        void linesCounted(int firstDocument, const QVector<int> &lines);
+
     protected:
 
         /*
@@ -40,12 +90,55 @@ namespace Robomongo
         */
         virtual void run();
     private:
+        /**
+         * @brief Formats documents of 'chunk', called from threads of pool
+         */
+        void formatChunk(size_t chunk);
+
+        /**
+         * @brief Waits until 'chunk' is formatted and takes its parts
+         */
+        void takeChunk(size_t chunk, std::vector<QString> &parts, QVector<int> &lines);
+
+        /**
+         * @brief Waits until the first 'count' chunks are formatted (or skipped
+         * after stop), so that no task of pool uses this thread
+         */
+        void waitForChunks(size_t count);
+
+        /**
+         * @brief Emits 'part', if previous part is processed
+         * @param wait: wait for processing of previous part, unless thread is stopped
+         * @return true, if part was emitted
+         */
+        bool emitPart(const QString &part, bool wait);
+
         /*
         ** List of documents
         */
         const std::vector<MongoDocumentPtr> _bsonObjects;
         const UUIDEncoding _uuidEncoding;
         const SupportedTimes _timeZone;
+
+        /*
+        ** 1-based number of the first document, used when documents are appended
+        */
+        const int _startPosition;
+        const Mode _mode;
         volatile bool _stop;
+
+        /*
+        ** Formatted parts (or numbers of lines) of chunks, guarded by _mutex
+        */
+        std::vector<std::vector<QString> > _chunks;
+        std::vector<QVector<int> > _chunkLines;
+        std::vector<bool> _readyChunks;
+        QMutex _mutex;
+        QWaitCondition _chunkReady;
+
+        /*
+        ** Available while no emitted part waits for processing
+        */
+        QSemaphore _partSlot;
     };
 }
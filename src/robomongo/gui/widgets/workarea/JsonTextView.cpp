@@ -0,0 +1,271 @@
+#include "robomongo/gui/widgets/workarea/JsonTextView.h"
+
+#include <algorithm>
+#include <QApplication>
+#include <QHBoxLayout>
+#include <QInputDialog>
+#include <QScrollBar>
+#include <QShortcut>
+#include <Qsci/qsciscintilla.h>
+
+#include "robomongo/core/domain/MongoDocument.h"
+#include "robomongo/core/utils/JsonWriter.h"
+#include "robomongo/core/utils/QtUtils.h"
+#include "robomongo/gui/editors/PlainJavaScriptEditor.h"
+#include "robomongo/gui/widgets/workarea/JsonPrepareThread.h"
+
+namespace Robomongo
+{
+    JsonTextView::JsonTextView(UUIDEncoding uuidEncoding, SupportedTimes timeZone, QWidget *parent) :
+        BaseClass(parent),
+        _windowFirst(0),
+        _windowLast(0),
+        _isLoading(false),
+        _scrollBar(new QScrollBar(Qt::Vertical, this)),
+        _uuidEncoding(uuidEncoding),
+        _timeZone(timeZone)
+    {
+        _firstLines.push_back(0);
+
+        // Scroll bar of editor shows position in window only
+        sciScintilla()->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+        editorLayout()->addWidget(_scrollBar);
+        _scrollBar->setRange(0, 0);
+
+        // Margin shows numbers of lines of the whole text, filled when window is loaded
+        sciScintilla()->SendScintilla(QsciScintilla::SCI_SETMARGINTYPEN, 0, QsciScintilla::SC_MARGIN_RTEXT);
+
+        VERIFY(connect(sciScintilla()->verticalScrollBar(), SIGNAL(valueChanged(int)), this, SLOT(editorScrolled())));
+        VERIFY(connect(_scrollBar, SIGNAL(valueChanged(int)), this, SLOT(scrollBarMoved(int))));
+
+        // Ctrl+G is a shortcut of this view only, editor does not pass it to parent
+        QShortcut *goToLineShortcut = new QShortcut(QKeySequence(Qt::CTRL + Qt::Key_G), this);
+        goToLineShortcut->setContext(Qt::WidgetWithChildrenShortcut);
+        VERIFY(connect(goToLineShortcut, SIGNAL(activated()), this, SLOT(goToLine())));
+    }
+
+    void JsonTextView::appendDocuments(const std::vector<MongoDocumentPtr> &documents)
+    {
+        _documents.insert(_documents.end(), documents.begin(), documents.end());
+    }
+
+    void JsonTextView::addLineCounts(int firstDocument, const QVector<int> &lines)
+    {
+        const int counted = countedDocuments();
+        if (firstDocument != counted || counted + lines.size() > _documents.size())
+            return;
+
+        for (QVector<int>::const_iterator it = lines.begin(); it != lines.end(); ++it)
+            _firstLines.push_back(_firstLines.back() + *it);
+
+        sciScintilla()->setMaxLineNumber(linesCount());
+
+        // Show first documents, or extend window, that ends with the last counted
+        // document, while it has less lines below visible area than needed
+        if (_windowLast == 0) {
+            loadWindow(0);
+        }
+        else if (_windowLast == counted) {
+            int top = windowFirstLine() + editorFirstVisibleLine();
+            if (_firstLines[_windowLast] - top < std::max<int>(minWindowLines, 3 * visibleLines()))
+                loadWindow(top);
+        }
+
+        updateScrollBar();
+    }
+
+    int JsonTextView::linesCount() const
+    {
+        return countedDocuments() ? _firstLines.back() + 1 : 0;
+    }
+
+    void JsonTextView::showLine(int line)
+    {
+        if (!countedDocuments())
+            return;
+
+        line = std::max(0, std::min(line, linesCount() - 1));
+        int editorLine = line - windowFirstLine();
+        int windowLines = _firstLines[_windowLast] - windowFirstLine() + 1;
+        if (editorLine < 0 || editorLine >= windowLines) {
+            loadWindow(std::max(0, line - visibleLines() / 2));
+            editorLine = line - windowFirstLine();
+        }
+
+        sciScintilla()->setCursorPosition(editorLine, 0);
+        sciScintilla()->ensureLineVisible(editorLine);
+        sciScintilla()->setFocus();
+    }
+
+    void JsonTextView::goToLine()
+    {
+        int lines = linesCount();
+        if (!lines)
+            return;
+
+        int line = 0, index = 0;
+        sciScintilla()->getCursorPosition(&line, &index);
+
+        bool ok = false;
+        int number = QInputDialog::getInt(this, tr("Go to Line"), tr("Line number (1 - %1):").arg(lines),
+                                          windowFirstLine() + line + 1, 1, lines, 1, &ok);
+        if (ok)
+            showLine(number - 1);
+    }
+
+    void JsonTextView::resizeEvent(QResizeEvent *e)
+    {
+        BaseClass::resizeEvent(e);
+        updateScrollBar();
+    }
+
+    bool JsonTextView::loadTextForSearch(const QString &text, bool caseSensitive, bool forward)
+    {
+        const int counted = countedDocuments();
+        const int outside = counted - (_windowLast - _windowFirst);
+        if (outside <= 0)
+            return false;
+
+        QApplication::setOverrideCursor(Qt::WaitCursor);
+
+        // Documents after window (before it, for backward search), then from the other end
+        std::string buffer;
+        JsonWriter writer(buffer, mongo::TenGen, _uuidEncoding, _timeZone);
+        const Qt::CaseSensitivity cs = caseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive;
+        int found = -1;
+        for (int i = 0; i < outside && found < 0; ++i) {
+            int document = forward ? (_windowLast + i) % counted : (_windowFirst - 1 - i + counted) % counted;
+            buffer.clear();
+            JsonPrepareThread::appendDocument(writer, buffer, _documents[document], document + 1);
+            if (QtUtils::toQString(buffer).contains(text, cs))
+                found = document;
+        }
+
+        QApplication::restoreOverrideCursor();
+
+        if (found < 0)
+            return false;
+
+        loadWindow(_firstLines[found]);
+
+        // Search continues from the beginning (or the end) of found document
+        if (forward) {
+            sciScintilla()->setCursorPosition(_firstLines[found] - windowFirstLine(), 0);
+        }
+        else {
+            int line = _firstLines[found + 1] - windowFirstLine();
+            sciScintilla()->setCursorPosition(line, sciScintilla()->lineLength(line));
+        }
+        return true;
+    }
+
+    void JsonTextView::editorScrolled()
+    {
+        if (_isLoading)
+            return;
+
+        const int top = editorFirstVisibleLine();
+        const int visible = visibleLines();
+        const int editorLines = sciScintilla()->lines();
+
+        // Window is moved, when user scrolls editor close to its edges
+        bool nearTop = top < visible && _windowFirst > 0;
+        bool nearBottom = top + 2 * visible > editorLines && _windowLast < countedDocuments();
+        if (nearTop || nearBottom)
+            loadWindow(windowFirstLine() + top);
+
+        updateScrollBar();
+    }
+
+    void JsonTextView::scrollBarMoved(int value)
+    {
+        if (_isLoading || !countedDocuments())
+            return;
+
+        const int editorLine = value - windowFirstLine();
+        const int windowLines = _firstLines[_windowLast] - windowFirstLine() + 1;
+        if (editorLine >= 0 && editorLine + visibleLines() <= windowLines) {
+            _isLoading = true;
+            sciScintilla()->SendScintilla(QsciScintilla::SCI_SETFIRSTVISIBLELINE, editorLine);
+            _isLoading = false;
+            return;
+        }
+
+        loadWindow(value);
+    }
+
+    int JsonTextView::documentAtLine(int line) const
+    {
+        const int counted = countedDocuments();
+        std::vector<int>::const_iterator it = std::upper_bound(_firstLines.begin(), _firstLines.begin() + counted, line);
+        return std::max<int>(0, std::min<int>(counted - 1, (it - _firstLines.begin()) - 1));
+    }
+
+    int JsonTextView::editorFirstVisibleLine() const
+    {
+        return sciScintilla()->SendScintilla(QsciScintilla::SCI_GETFIRSTVISIBLELINE);
+    }
+
+    int JsonTextView::visibleLines() const
+    {
+        return std::max<int>(1, sciScintilla()->SendScintilla(QsciScintilla::SCI_LINESONSCREEN));
+    }
+
+    void JsonTextView::loadWindow(int line)
+    {
+        const int counted = countedDocuments();
+        if (!counted)
+            return;
+
+        // Window has about the same number of lines before and after 'line'
+        const int windowLines = std::max<int>(minWindowLines, 3 * visibleLines());
+        const int document = documentAtLine(line);
+        int first = document;
+        while (first > 0 && _firstLines[document] - _firstLines[first] < windowLines / 2)
+            --first;
+
+        int last = document + 1;
+        while (last < counted && _firstLines[last] - _firstLines[first] < windowLines)
+            ++last;
+
+        // Cursor is kept, if it stays in window
+        int cursorLine = 0, cursorIndex = 0;
+        sciScintilla()->getCursorPosition(&cursorLine, &cursorIndex);
+        cursorLine += windowFirstLine();
+
+        std::string buffer;
+        JsonWriter writer(buffer, mongo::TenGen, _uuidEncoding, _timeZone);
+        for (int i = first; i < last; ++i)
+            JsonPrepareThread::appendDocument(writer, buffer, _documents[i], i + 1);
+
+        _isLoading = true;
+        _windowFirst = first;
+        _windowLast = last;
+        sciScintilla()->setText(QtUtils::toQString(buffer));
+
+        const int windowEnd = _firstLines[_windowLast];
+        for (int i = 0; i <= windowEnd - windowFirstLine(); ++i)
+            sciScintilla()->setMarginText(i, QString::number(windowFirstLine() + i + 1), QsciScintilla::STYLE_LINENUMBER);
+
+        if (cursorLine >= windowFirstLine() && cursorLine <= windowEnd)
+            sciScintilla()->setCursorPosition(cursorLine - windowFirstLine(), cursorIndex);
+
+        line = std::max(windowFirstLine(), std::min(line, windowEnd));
+        sciScintilla()->SendScintilla(QsciScintilla::SCI_SETFIRSTVISIBLELINE, line - windowFirstLine());
+        _isLoading = false;
+
+        updateScrollBar();
+    }
+
+    void JsonTextView::updateScrollBar()
+    {
+        const int visible = visibleLines();
+        _scrollBar->blockSignals(true);
+        _scrollBar->setRange(0, std::max(0, linesCount() - visible));
+        _scrollBar->setPageStep(visible);
+        _scrollBar->setSingleStep(1);
+        if (countedDocuments())
+            _scrollBar->setValue(windowFirstLine() + editorFirstVisibleLine());
+        _scrollBar->blockSignals(false);
+    }
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <vector>
+#include <QVector>
+
+#include "robomongo/core/Core.h"
+#include "robomongo/core/Enums.h"
+#include "robomongo/gui/editors/FindFrame.h"
+
+QT_BEGIN_NAMESPACE
+class QScrollBar;
+QT_END_NAMESPACE
+
+namespace Robomongo
+{
+    /**
+     * @brief Text view of large results, that does not keep text of all documents.
+     *
+     *        Only documents in and near the visible area ("window") are formatted
+     *        and loaded into the editor, the whole text is represented by separate
+     *        vertical scroll bar. Numbers of lines of documents are counted by
+     *        JsonPrepareThread in CountLines mode, documents are shown as soon as
+     *        their lines are counted.
+     *
+     *        Ctrl+G goes to line of the whole text. Search continues in documents
+     *        outside of window, they are formatted one by one until text is found.
+     */
+    class JsonTextView : public FindFrame
+    {
+        Q_OBJECT
+
+    public:
+        typedef FindFrame BaseClass;
+
+        /**
+         * @brief Results with this number of documents are shown by JsonTextView
+         */
+        enum { minDocumentsCount = 1000 };
+
+        /**
+         * @brief Minimum number of lines loaded into editor
+         */
+        enum { minWindowLines = 1000 };
+
+        JsonTextView(UUIDEncoding uuidEncoding, SupportedTimes timeZone, QWidget *parent);
+
+        void appendDocuments(const std::vector<MongoDocumentPtr> &documents);
+
+        /**
+         * @brief Adds numbers of lines of documents starting from 'firstDocument'.
+         * Lines should be added in order of documents.
+         */
+        void addLineCounts(int firstDocument, const QVector<int> &lines);
+
+        /**
+         * @brief Number of lines of counted documents
+         */
+        int linesCount() const;
+
+        /**
+         * @brief Scrolls to 0-based line of the whole text and moves cursor there
+         */
+        void showLine(int line);
+
+    protected:
+        virtual void resizeEvent(QResizeEvent *e);
+        virtual bool loadTextForSearch(const QString &text, bool caseSensitive, bool forward);
+
+    private Q_SLOTS:
+        void editorScrolled();
+        void scrollBarMoved(int value);
+        void goToLine();
+
+    private:
+        int countedDocuments() const { return _firstLines.size() - 1; }
+        int documentAtLine(int line) const;
+        int windowFirstLine() const { return _firstLines[_windowFirst]; }
+        int editorFirstVisibleLine() const;
+        int visibleLines() const;
+
+        /**
+         * @brief Loads documents around 'line' into editor and scrolls
+         * editor so that 'line' is the first visible line
+         */
+        void loadWindow(int line);
+        void updateScrollBar();
+
+        std::vector<MongoDocumentPtr> _documents;
+
+        /**
+         * @brief First line of each counted document, and number of
+         * '\n' characters in text of all counted documents at the end
+         */
+        std::vector<int> _firstLines;
+
+        int _windowFirst;   // first document loaded into editor
+        int _windowLast;    // document after the last one loaded into editor
+        bool _isLoading;    // editor is changed by view, not by user
+
+        QScrollBar *const _scrollBar;
+        const UUIDEncoding _uuidEncoding;
+        const SupportedTimes _timeZone;
+    };
+}
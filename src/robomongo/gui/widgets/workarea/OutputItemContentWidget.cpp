@@ -2,15 +2,18 @@
 
 #include <QVBoxLayout>
 #include <Qsci/qscilexerjavascript.h>
+#include <mongo/client/dbclientinterface.h>
 
 #include "robomongo/core/AppRegistry.h"
 #include "robomongo/core/settings/SettingsManager.h"
 #include "robomongo/core/utils/QtUtils.h"
 #include "robomongo/core/domain/MongoShell.h"
+#include "robomongo/core/domain/MongoDocument.h"
 
 #include "robomongo/gui/widgets/workarea/OutputWidget.h"
 #include "robomongo/gui/widgets/workarea/OutputItemHeaderWidget.h"
 #include "robomongo/gui/widgets/workarea/JsonPrepareThread.h"
+#include "robomongo/gui/widgets/workarea/JsonTextView.h"
 #include "robomongo/gui/widgets/workarea/BsonTreeView.h"
 #include "robomongo/gui/widgets/workarea/BsonTreeModel.h"
 #include "robomongo/gui/widgets/workarea/BsonTableView.h"
@@ -26,8 +29,10 @@ namespace Robomongo
     OutputItemContentWidget::OutputItemContentWidget(OutputWidget *out, ViewMode viewMode, MongoShell *shell, const QString &text, double secs, QWidget *parent) :
         BaseClass(parent),
         _textView(NULL),
+        _jsonView(NULL),
         _bsonTreeview(NULL),
         _thread(NULL),
+        _jsonPreparedCount(0),
         _bsonTable(NULL),
         _isTextModeSupported(true),
         _isTreeModeSupported(false),
@@ -52,8 +57,10 @@ namespace Robomongo
     OutputItemContentWidget::OutputItemContentWidget(OutputWidget *out, ViewMode viewMode, MongoShell *shell, const QString &type, const std::vector<MongoDocumentPtr> &documents, const MongoQueryInfo &queryInfo, double secs, QWidget *parent) :
         BaseClass(parent),
         _textView(NULL),
+        _jsonView(NULL),
         _bsonTreeview(NULL),
         _thread(NULL),
+        _jsonPreparedCount(0),
         _bsonTable(NULL),
         _isTextModeSupported(true),
         _isTreeModeSupported(true),
@@ -77,6 +84,13 @@ namespace Robomongo
         setup(secs);
     }
 
+    OutputItemContentWidget::~OutputItemContentWidget()
+    {
+        // Thread waits for processing of emitted parts, nobody will process them now
+        if (_thread)
+            _thread->stop();
+    }
+
     void OutputItemContentWidget::setup(double secs)
     {      
         setContentsMargins(0, 0, 0, 0);
@@ -134,11 +148,38 @@ namespace Robomongo
 
     void OutputItemContentWidget::paging_rightClicked(int skip, int limit)
     {
+        // When next page starts right after the last shown document,
+        // it can be loaded by sort key of that document instead of skip
+        mongo::BSONObj boundary;
+        if (skip == _queryInfo._skip && limit == static_cast<int>(_documents.size()))
+            boundary = lastSortKey();
+
         skip += limit;
-        refresh(skip, limit);
+        loadPage(skip, limit, boundary);
     }
 
     void OutputItemContentWidget::refresh(int skip, int batchSize)
+    {
+        loadPage(skip, batchSize, mongo::BSONObj());
+    }
+
+    mongo::BSONObj OutputItemContentWidget::lastSortKey() const
+    {
+        mongo::BSONObj sortOrder = _queryInfo.sortOrder();
+        if (sortOrder.nFields() != 1 || _documents.empty())
+            return mongo::BSONObj();
+
+        std::string fieldName = sortOrder.firstElementFieldName();
+        mongo::BSONElement value = _documents.back()->bsonObj().getFieldDotted(fieldName);
+        if (value.eoo())
+            return mongo::BSONObj();
+
+        mongo::BSONObjBuilder builder;
+        builder.appendAs(value, fieldName);
+        return builder.obj();
+    }
+
+    void OutputItemContentWidget::loadPage(int skip, int batchSize, const mongo::BSONObj &boundary)
     {
         // Cannot set skip lower than in the text query
         if (skip <  _initialSkip) {
@@ -164,6 +205,7 @@ namespace Robomongo
         info._limit = limit;
         info._skip = skip;
         info._batchSize = batchSize;
+        info._boundary = boundary;
         _out->showProgress();
         _shell->query(_out->resultIndex(this), info);
     }
@@ -196,10 +238,48 @@ namespace Robomongo
             _stack->removeWidget(_textView);
             delete _textView;
             _textView = NULL;
+            _jsonView = NULL;
         }
         configureModel();
     }
 
+    void OutputItemContentWidget::append(const std::vector<MongoDocumentPtr> &documents)
+    {
+        if (documents.empty())
+            return;
+
+        _documents.insert(_documents.end(), documents.begin(), documents.end());
+
+        // Tree and table views are updated through model signals
+        _mod->appendDocuments(documents);
+
+        if (_jsonView)
+            _jsonView->appendDocuments(documents);
+
+        // Result became large, text view is recreated as JsonTextView
+        if (_isTextModeInitialized && !_jsonView && _text.isEmpty()
+            && _documents.size() >= JsonTextView::minDocumentsCount) {
+            if (_thread) {
+                _thread->stop();
+                _thread = NULL;
+            }
+
+            _stack->removeWidget(_textView);
+            delete _textView;
+            _textView = NULL;
+            _isTextModeInitialized = false;
+            _isFirstPartRendered = false;
+
+            if (_viewMode == Text)
+                showText();
+            return;
+        }
+
+        // Previous JsonPrepareThread will pick up new documents when done
+        if (_isTextModeInitialized && !_thread)
+            prepareJson();
+    }
+
     void OutputItemContentWidget::showText()
     {
         _viewMode = Text;
@@ -209,17 +289,25 @@ namespace Robomongo
 
         if (!_isTextModeInitialized)
         {
-            _textView = configureLogText();
+            // Large results are formatted only around visible area
+            if (_text.isEmpty() && _documents.size() >= JsonTextView::minDocumentsCount) {
+                _jsonView = new JsonTextView(AppRegistry::instance().settingsManager()->uuidEncoding(),
+                                             AppRegistry::instance().settingsManager()->timeZone(), this);
+                _jsonView->appendDocuments(_documents);
+                _textView = configureLogText(_jsonView);
+            }
+            else {
+                _textView = configureLogText(new FindFrame(this));
+            }
+
             if (!_text.isEmpty()) {
                 _textView->sciScintilla()->setText(_text);
             }
             else {
+                _jsonPreparedCount = 0;
                 if (_documents.size() > 0) {
                     _textView->sciScintilla()->setText("Loading...");
-                    _thread = new JsonPrepareThread(_documents, AppRegistry::instance().settingsManager()->uuidEncoding(), AppRegistry::instance().settingsManager()->timeZone());
-                    VERIFY(connect(_thread, SIGNAL(partReady(const QString&)), this, SLOT(jsonPartReady(const QString&))));
-                    VERIFY(connect(_thread, SIGNAL(finished()), _thread, SLOT(deleteLater())));
-                    _thread->start();
+                    prepareJson();
                 }
             }
             _stack->addWidget(_textView);
@@ -332,9 +420,53 @@ namespace Robomongo
                     _textView->sciScintilla()->setText(json);
                 _isFirstPartRendered = true;
             }
+
+            // Allow the thread to emit next part
+            if (thread)
+                thread->partProcessed();
         }
     }
     
+    void OutputItemContentWidget::jsonLinesCounted(int firstDocument, const QVector<int> &lines)
+    {
+        JsonPrepareThread *thread = qobject_cast<JsonPrepareThread *>(sender());
+        if (thread && thread != _thread) {
+            // Thread of previous documents, it is not needed anymore
+            thread->stop();
+            return;
+        }
+
+        if (_jsonView)
+            _jsonView->addLineCounts(firstDocument, lines);
+    }
+
+    void OutputItemContentWidget::jsonPrepared()
+    {
+        JsonPrepareThread *thread = qobject_cast<JsonPrepareThread *>(sender());
+        if (thread != _thread)
+            return;
+
+        _thread = NULL;
+
+        // Documents were appended while thread was running
+        if (_isTextModeInitialized && _jsonPreparedCount < _documents.size())
+            prepareJson();
+    }
+
+    void OutputItemContentWidget::prepareJson()
+    {
+        std::vector<MongoDocumentPtr> documents(_documents.begin() + _jsonPreparedCount, _documents.end());
+        JsonPrepareThread::Mode mode = _jsonView ? JsonPrepareThread::CountLines : JsonPrepareThread::FormatText;
+        _thread = new JsonPrepareThread(documents, AppRegistry::instance().settingsManager()->uuidEncoding(),
+                                        AppRegistry::instance().settingsManager()->timeZone(), _jsonPreparedCount + 1, mode);
+        _jsonPreparedCount = _documents.size();
+        VERIFY(connect(_thread, SIGNAL(partReady(const QString&)), this, SLOT(jsonPartReady(const QString&))));
+        VERIFY(connect(_thread, SIGNAL(linesCounted(int, const QVector<int>&)), this, SLOT(jsonLinesCounted(int, const QVector<int>&))));
+        VERIFY(connect(_thread, SIGNAL(done()), this, SLOT(jsonPrepared())));
+        VERIFY(connect(_thread, SIGNAL(finished()), _thread, SLOT(deleteLater())));
+        _thread->start();
+    }
+
     BsonTreeModel *OutputItemContentWidget::configureModel()
     {
         delete _mod;
@@ -342,14 +474,14 @@ namespace Robomongo
         return _mod;
     }
 
-    FindFrame *Robomongo::OutputItemContentWidget::configureLogText()
+    FindFrame *Robomongo::OutputItemContentWidget::configureLogText(FindFrame *logText)
     {
         const QFont &textFont = GuiRegistry::instance().font();
 
         QsciLexerJavaScript *javaScriptLexer = new JSLexer(this);
         javaScriptLexer->setFont(textFont);
 
-        FindFrame *_logText = new FindFrame(this);
+        FindFrame *_logText = logText;
         _logText->sciScintilla()->setLexer(javaScriptLexer);
         _logText->sciScintilla()->setTabWidth(4);        
         _logText->sciScintilla()->setAppropriateBraceMatching();
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QStackedWidget>
+#include <QVector>
 
 #include "robomongo/core/Core.h"
 #include "robomongo/core/domain/MongoQueryInfo.h"
@@ -10,6 +11,7 @@
 namespace Robomongo
 {
     class FindFrame;
+    class JsonTextView;
     class BsonTreeView;
     class BsonTableView;
     class BsonTreeModel;
@@ -27,9 +29,11 @@ namespace Robomongo
         typedef QWidget BaseClass;
         OutputItemContentWidget(OutputWidget *out, ViewMode viewMode, MongoShell *shell, const QString &text, double secs, QWidget *parent = NULL);
         OutputItemContentWidget(OutputWidget *out, ViewMode viewMode, MongoShell *shell, const QString &type, const std::vector<MongoDocumentPtr> &documents, const MongoQueryInfo &queryInfo, double secs, QWidget *parent = NULL);
+        ~OutputItemContentWidget();
         int _initialSkip;
         int _initialLimit;
         void update(const MongoQueryInfo &inf, const std::vector<MongoDocumentPtr> &documents);
+        void append(const std::vector<MongoDocumentPtr> &documents);
         bool isTextModeSupported() const { return _isTextModeSupported; }
         bool isTreeModeSupported() const { return _isTreeModeSupported; }
         bool isCustomModeSupported() const { return _isCustomModeSupported; }
@@ -51,16 +55,22 @@ namespace Robomongo
 
     private Q_SLOTS:
         void jsonPartReady(const QString &json);
+        void jsonLinesCounted(int firstDocument, const QVector<int> &lines);
+        void jsonPrepared();
         void refresh(int skip, int batchSize);
         void paging_rightClicked(int skip, int batchSize);
         void paging_leftClicked(int skip, int limit);      
 
     private:
         void setup(double secs);
-        FindFrame *configureLogText();
+        FindFrame *configureLogText(FindFrame *logText);
         BsonTreeModel *configureModel();
+        void prepareJson();
+        void loadPage(int skip, int batchSize, const mongo::BSONObj &boundary);
+        mongo::BSONObj lastSortKey() const;
 
         FindFrame *_textView;
+        JsonTextView *_jsonView; // _textView of large results, NULL otherwise
         BsonTreeView *_bsonTreeview;
         BsonTableView *_bsonTable;
         BsonTreeModel *_mod;
@@ -73,6 +83,7 @@ namespace Robomongo
 
         QStackedWidget *_stack;
         JsonPrepareThread *_thread;
+        size_t _jsonPreparedCount; // number of documents passed to JsonPrepareThread
 
         MongoShell *_shell;
         OutputItemHeaderWidget *_header;
@@ -71,6 +71,15 @@ namespace Robomongo
         output->refreshOutputItem();
     }
 
+    void OutputWidget::appendToPart(int partIndex, const std::vector<MongoDocumentPtr> &documents)
+    {
+        if (partIndex >= _splitter->count())
+            return;
+
+        OutputItemContentWidget *output = (OutputItemContentWidget *) _splitter->widget(partIndex);
+        output->append(documents);
+    }
+
     void OutputWidget::toggleOrientation()
     {
         if (_splitter->orientation() == Qt::Horizontal)
@@ -194,7 +194,8 @@ namespace Robomongo
 
     void QueryWidget::handle(DocumentListLoadedEvent *event)
     {
-        hideProgress();
+        if (event->lastBatch())
+            hideProgress();
 
         if (event->isError()) {
             QString message = QString("Failed to load documents.\n\nError:\n%1")
@@ -203,7 +204,11 @@ namespace Robomongo
             return;
         }
 
-        _viewer->updatePart(event->resultIndex(), event->queryInfo(), event->documents()); // this should be in viewer, subscribed to ScriptExecutedEvent
+        // this should be in viewer, subscribed to ScriptExecutedEvent
+        if (event->firstBatch())
+            _viewer->updatePart(event->resultIndex(), event->queryInfo(), event->documents());
+        else
+            _viewer->appendToPart(event->resultIndex(), event->documents());
     }
 
     void QueryWidget::handle(ScriptExecutedEvent *event)